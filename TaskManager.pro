@@ -1,7 +1,13 @@
-# 核心模块（Qt 5/6通用）
-QT += core gui widgets sql
+# 需要Qt 6：异步数据库接口使用QFuture::then和QPromise
+lessThan(QT_MAJOR_VERSION, 6): error("TaskManager需要Qt 6（使用了QFuture::then和QPromise），当前为Qt $$[QT_VERSION]")
 
-# C++标准（Qt 5/6均支持C++17）
+# 核心模块
+QT += core gui widgets sql concurrent
+# 在线备份和中断搜索直接调用SQLite C API（经QSqlDriver::handle()取得连接句柄），需与QSQLITE驱动使用同一个SQLite库
+# （Qt以-system-sqlite构建，Linux发行版的Qt均如此）；驱动内置了另一版本的SQLite时，程序在运行时退回只用SQL的做法
+LIBS += -lsqlite3
+
+# C++标准
 CONFIG += c++17
 DEFINES += QT_DEPRECATED_WARNINGS
 
@@ -18,8 +24,16 @@ SOURCES += main.cpp \
            sqlrepository.cpp \
            taskmanager.cpp \
            reminderthread.cpp \
+           backupthread.cpp \
+           exportthread.cpp \
            fileexporter.cpp \
-           taskmodel.cpp
+           fileimporter.cpp \
+           taskmodel.cpp \
+           taskstore.cpp \
+           categorydictionary.cpp \
+           taskorder.cpp \
+           tasksnapshot.cpp \
+           logging.cpp
 
 # 头文件列表（所有.h文件）
 HEADERS += mainwindow.h \
@@ -28,8 +42,16 @@ HEADERS += mainwindow.h \
            sqlrepository.h \
            taskmanager.h \
            reminderthread.h \
+           backupthread.h \
+           exportthread.h \
            fileexporter.h \
-           taskmodel.h
+           fileimporter.h \
+           taskmodel.h \
+           taskstore.h \
+           categorydictionary.h \
+           taskorder.h \
+           tasksnapshot.h \
+           logging.h
 
 # UI文件列表（.ui文件）
 FORMS += mainwindow.ui \
@@ -0,0 +1,37 @@
+#include "backupthread.h"
+#include "logging.h"
+
+BackupThread::BackupThread(const QString &backupPath, QObject *parent)
+    : QThread(parent)
+    , m_repo(SqlRepository::getInstance())
+    , m_backupPath(backupPath)
+{
+}
+
+QString BackupThread::backupPath() const
+{
+    return m_backupPath;
+}
+
+void BackupThread::cancel()
+{
+    m_canceled.storeRelaxed(1);
+}
+
+void BackupThread::run()
+{
+    bool success = m_repo.backupDatabase(m_backupPath, [this](qint64 bytesCopied, qint64 bytesTotal) {
+        emit backupProgress(bytesCopied, bytesTotal);
+        return !m_canceled.loadRelaxed();
+    });
+
+    // 取消请求在全部复制完之后才到达时，备份视为成功
+    bool canceled = !success && m_canceled.loadRelaxed();
+    if (canceled) {
+        qCInfo(lcSql) << "数据库备份已取消：" << m_backupPath;
+    }
+
+    // 备份完成后立即释放本线程的连接
+    m_repo.releaseThreadConnection();
+    emit backupFinished(success, canceled, m_backupPath);
+}
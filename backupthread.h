@@ -0,0 +1,33 @@
+#ifndef BACKUPTHREAD_H
+#define BACKUPTHREAD_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include "sqlrepository.h"
+
+// 后台数据库备份线程：使用本线程独立的连接执行在线备份，界面与其他连接不受影响
+class BackupThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit BackupThread(const QString &backupPath, QObject *parent = nullptr);
+
+    QString backupPath() const;
+    void cancel(); // 请求取消备份（可在任意线程调用），在当前一步复制完成后停止，已有的备份文件保持不变
+
+signals:
+    // 备份进度（已复制字节数/总字节数）
+    void backupProgress(qint64 bytesWritten, qint64 bytesTotal);
+    // 备份结束（canceled为true表示被取消）
+    void backupFinished(bool success, bool canceled, const QString &backupPath);
+
+protected:
+    void run() override; // 线程执行入口
+
+private:
+    SqlRepository &m_repo;
+    QString m_backupPath; // 备份文件路径
+    QAtomicInt m_canceled; // 取消标志
+};
+
+#endif // BACKUPTHREAD_H
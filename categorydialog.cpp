@@ -10,7 +10,7 @@ CategoryDialog::~CategoryDialog()
 {
 }
 
-void CategoryDialog::setCategories(const QList<Category> &categories)
+void CategoryDialog::setCategories(const CategoryDictionary &categories)
 {
     m_categories = categories;
     refreshCategoryList();
@@ -18,7 +18,7 @@ void CategoryDialog::setCategories(const QList<Category> &categories)
 
 QList<Category> CategoryDialog::getCategories() const
 {
-    return m_categories;
+    return m_categories.categories();
 }
 
 void CategoryDialog::initUI()
@@ -79,7 +79,7 @@ void CategoryDialog::refreshCategoryList()
 {
     m_categoryListWidget->clear();
     
-    for (const Category &category : m_categories) {
+    for (const Category &category : m_categories.categories()) {
         QListWidgetItem *item = new QListWidgetItem(category.categoryName);
         item->setData(Qt::UserRole, category.categoryId);
         m_categoryListWidget->addItem(item);
@@ -96,11 +96,9 @@ void CategoryDialog::onAddCategoryClicked()
     }
     
     // 检查分类是否已存在
-    for (const Category &category : m_categories) {
-        if (category.categoryName == categoryName) {
-            QMessageBox::warning(this, tr("警告"), tr("该分类已存在！"));
-            return;
-        }
+    if (m_categories.id(categoryName) != -1) {
+        QMessageBox::warning(this, tr("警告"), tr("该分类已存在！"));
+        return;
     }
     
     // 发出添加分类信号
@@ -119,13 +117,7 @@ void CategoryDialog::onDeleteCategoryClicked()
     }
     
     // 找到选中的分类名称
-    QString categoryName;
-    for (const Category &category : m_categories) {
-        if (category.categoryId == m_selectedCategoryId) {
-            categoryName = category.categoryName;
-            break;
-        }
-    }
+    QString categoryName = m_categories.name(m_selectedCategoryId);
     
     // 确认删除
     if (QMessageBox::question(this, tr("确认删除"),
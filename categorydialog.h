@@ -11,6 +11,7 @@
 #include <QLabel>
 #include <QMessageBox>
 #include "sqlrepository.h"
+#include "categorydictionary.h"
 
 class CategoryDialog : public QDialog
 {
@@ -20,7 +21,7 @@ public:
     explicit CategoryDialog(QWidget *parent = nullptr);
     ~CategoryDialog() override;
 
-    void setCategories(const QList<Category> &categories);
+    void setCategories(const CategoryDictionary &categories);
     QList<Category> getCategories() const;
 
 signals:
@@ -36,7 +37,7 @@ private:
     void initUI();
     void refreshCategoryList();
 
-    QList<Category> m_categories;
+    CategoryDictionary m_categories;
     int m_selectedCategoryId = -1;
 
     // UI控件
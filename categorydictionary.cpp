@@ -0,0 +1,90 @@
+#include "categorydictionary.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+CategoryDictionary::CategoryDictionary(const QList<Category> &categories)
+    : m_categories(categories)
+{
+    int maxId = -1;
+    for (const Category &category : categories) {
+        maxId = qMax(maxId, category.categoryId);
+    }
+
+    // 最大ID不超过分类数的若干倍时使用稠密数组（删除分类留下的空洞很少）
+    bool dense = maxId >= 0 && maxId < categories.size() * 4 + 64;
+    if (dense) {
+        m_denseIndex.fill(-1, maxId + 1);
+    } else {
+        m_sparseIndex.reserve(categories.size());
+    }
+    m_idsByName.reserve(categories.size());
+
+    for (int i = 0; i < categories.size(); ++i) {
+        const Category &category = categories.at(i);
+        if (dense) {
+            if (category.categoryId >= 0) {
+                m_denseIndex[category.categoryId] = i;
+            }
+        } else {
+            m_sparseIndex.insert(category.categoryId, i);
+        }
+        m_idsByName.insert(category.categoryName, category.categoryId);
+    }
+
+    // 分类数很少，构建时按本地化规则排好名称顺序
+    QList<int> order(categories.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&categories](int a, int b) {
+        return QString::localeAwareCompare(categories.at(a).categoryName, categories.at(b).categoryName) < 0;
+    });
+    m_ranks.resize(categories.size());
+    for (int i = 0; i < order.size(); ++i) {
+        m_ranks[order.at(i)] = i;
+    }
+}
+
+const QList<Category> &CategoryDictionary::categories() const
+{
+    return m_categories;
+}
+
+int CategoryDictionary::size() const
+{
+    return m_categories.size();
+}
+
+bool CategoryDictionary::isEmpty() const
+{
+    return m_categories.isEmpty();
+}
+
+bool CategoryDictionary::contains(int categoryId) const
+{
+    return indexOf(categoryId) != -1;
+}
+
+QString CategoryDictionary::name(int categoryId, const QString &defaultName) const
+{
+    int index = indexOf(categoryId);
+    return index != -1 ? m_categories.at(index).categoryName : defaultName;
+}
+
+int CategoryDictionary::id(const QString &categoryName) const
+{
+    return m_idsByName.value(categoryName, -1);
+}
+
+int CategoryDictionary::rank(int categoryId) const
+{
+    int index = indexOf(categoryId);
+    return index != -1 ? m_ranks.at(index) : std::numeric_limits<int>::max();
+}
+
+int CategoryDictionary::indexOf(int categoryId) const
+{
+    if (!m_denseIndex.isEmpty()) {
+        return categoryId >= 0 && categoryId < m_denseIndex.size() ? m_denseIndex.at(categoryId) : -1;
+    }
+    return m_sparseIndex.value(categoryId, -1);
+}
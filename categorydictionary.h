@@ -0,0 +1,40 @@
+#ifndef CATEGORYDICTIONARY_H
+#define CATEGORYDICTIONARY_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include "sqlrepository.h"
+
+// 分类字典：分类列表变化时构建一次，之后按ID取名称、按名称取ID都是O(1)
+// ID为自增主键，通常连续，按ID直接下标的稠密数组查找；ID过于稀疏时改用哈希表
+// 成员都是隐式共享的Qt容器，按值传递（包括传给后台线程只读使用）不复制数据
+class CategoryDictionary
+{
+public:
+    CategoryDictionary() = default;
+    explicit CategoryDictionary(const QList<Category> &categories);
+
+    const QList<Category> &categories() const; // 按数据库顺序的分类列表
+    int size() const;
+    bool isEmpty() const;
+    bool contains(int categoryId) const;
+
+    // 分类名称，不存在时返回defaultName
+    QString name(int categoryId, const QString &defaultName = QString()) const;
+    // 分类ID，不存在时返回-1
+    int id(const QString &categoryName) const;
+    // 分类按名称排序后的序号（用于按分类排序），不存在的分类排在最后
+    int rank(int categoryId) const;
+
+private:
+    int indexOf(int categoryId) const; // 分类在m_categories中的下标，不存在时返回-1
+
+    QList<Category> m_categories;
+    QList<int> m_ranks;                  // 与m_categories逐项对应的名称排序序号
+    QList<int> m_denseIndex;             // 分类ID -> 下标（-1表示该ID不存在），ID稀疏时为空
+    QHash<int, int> m_sparseIndex;       // 分类ID -> 下标，仅ID稀疏时使用
+    QHash<QString, int> m_idsByName;     // 分类名称 -> 分类ID
+};
+
+#endif // CATEGORYDICTIONARY_H
@@ -9,13 +9,83 @@ CREATE TABLE IF NOT EXISTS task (
     task_id INTEGER PRIMARY KEY AUTOINCREMENT,
     title TEXT NOT NULL,
     description TEXT,
-    deadline DATETIME NOT NULL,
+    deadline INTEGER NOT NULL, -- UTC秒级时间戳
     priority INTEGER DEFAULT 2,
     is_completed INTEGER DEFAULT 0,
     category_id INTEGER DEFAULT 1,
     FOREIGN KEY (category_id) REFERENCES category (category_id)
 );
 
+-- 筛选与提醒查询使用的索引（与SqlRepository迁移v2保持一致）
+CREATE INDEX IF NOT EXISTS idx_task_deadline ON task (deadline);
+CREATE INDEX IF NOT EXISTS idx_task_completed_deadline ON task (is_completed, deadline);
+CREATE INDEX IF NOT EXISTS idx_task_category_completed_deadline ON task (category_id, is_completed, deadline);
+CREATE INDEX IF NOT EXISTS idx_task_priority_completed_deadline ON task (priority, is_completed, deadline);
+
+-- 任务全文索引（FTS5 trigram分词，与SqlRepository迁移v3保持一致）
+-- 需要SQLite 3.34+且启用FTS5；不支持时省略本节（表和三个触发器），程序自动使用LIKE搜索
+CREATE VIRTUAL TABLE IF NOT EXISTS task_fts USING fts5(title, description, content='task', content_rowid='task_id', tokenize='trigram');
+CREATE TRIGGER IF NOT EXISTS task_fts_ai AFTER INSERT ON task BEGIN
+    INSERT INTO task_fts(rowid, title, description) VALUES (new.task_id, new.title, new.description);
+END;
+CREATE TRIGGER IF NOT EXISTS task_fts_ad AFTER DELETE ON task BEGIN
+    INSERT INTO task_fts(task_fts, rowid, title, description) VALUES ('delete', old.task_id, old.title, old.description);
+END;
+CREATE TRIGGER IF NOT EXISTS task_fts_au AFTER UPDATE OF title, description ON task BEGIN
+    INSERT INTO task_fts(task_fts, rowid, title, description) VALUES ('delete', old.task_id, old.title, old.description);
+    INSERT INTO task_fts(rowid, title, description) VALUES (new.task_id, new.title, new.description);
+END;
+
+-- 按分类和优先级汇总的任务计数（与SqlRepository迁移v7保持一致）
+-- 主键列不允许NULL（NULL不触发主键冲突），任务的分类或优先级为空时记为-1
+CREATE TABLE IF NOT EXISTS task_stats (
+    category_id INTEGER NOT NULL,
+    priority INTEGER NOT NULL,
+    total INTEGER NOT NULL DEFAULT 0,
+    completed INTEGER NOT NULL DEFAULT 0,
+    PRIMARY KEY (category_id, priority)
+);
+CREATE TRIGGER IF NOT EXISTS task_stats_ai AFTER INSERT ON task BEGIN
+    INSERT INTO task_stats (category_id, priority, total, completed)
+    VALUES (IFNULL(new.category_id, -1), IFNULL(new.priority, -1), 1, new.is_completed IS 1)
+    ON CONFLICT (category_id, priority) DO UPDATE SET total = total + 1, completed = completed + excluded.completed;
+END;
+CREATE TRIGGER IF NOT EXISTS task_stats_ad AFTER DELETE ON task BEGIN
+    UPDATE task_stats SET total = total - 1, completed = completed - (old.is_completed IS 1)
+    WHERE category_id = IFNULL(old.category_id, -1) AND priority = IFNULL(old.priority, -1);
+END;
+CREATE TRIGGER IF NOT EXISTS task_stats_au AFTER UPDATE OF category_id, priority, is_completed ON task BEGIN
+    UPDATE task_stats SET total = total - 1, completed = completed - (old.is_completed IS 1)
+    WHERE category_id = IFNULL(old.category_id, -1) AND priority = IFNULL(old.priority, -1);
+    INSERT INTO task_stats (category_id, priority, total, completed)
+    VALUES (IFNULL(new.category_id, -1), IFNULL(new.priority, -1), 1, new.is_completed IS 1)
+    ON CONFLICT (category_id, priority) DO UPDATE SET total = total + 1, completed = completed + excluded.completed;
+END;
+
+-- 任务数据版本号：任务每次增删改时递增，程序据此判断任务快照文件是否过期（与SqlRepository迁移v6保持一致）
+-- database_id为建库时随机生成的数据库标识（与SqlRepository迁移v8保持一致），防止误用另一个数据库文件的快照
+CREATE TABLE IF NOT EXISTS task_generation (
+    id INTEGER PRIMARY KEY CHECK (id = 1),
+    generation INTEGER NOT NULL,
+    database_id INTEGER NOT NULL DEFAULT 0
+);
+INSERT OR IGNORE INTO task_generation (id, generation, database_id) VALUES (1, 0, random());
+
+CREATE TRIGGER IF NOT EXISTS task_generation_ai AFTER INSERT ON task BEGIN
+    UPDATE task_generation SET generation = generation + 1 WHERE id = 1;
+END;
+
+CREATE TRIGGER IF NOT EXISTS task_generation_ad AFTER DELETE ON task BEGIN
+    UPDATE task_generation SET generation = generation + 1 WHERE id = 1;
+END;
+
+CREATE TRIGGER IF NOT EXISTS task_generation_au AFTER UPDATE ON task BEGIN
+    UPDATE task_generation SET generation = generation + 1 WHERE id = 1;
+END;
+
+-- 标记结构版本，程序启动时不再重复迁移
+PRAGMA user_version = 8;
+
 -- 插入初始分类数据
 INSERT OR IGNORE INTO category (category_id, category_name) VALUES
 (1, '工作'),
@@ -25,11 +95,11 @@ INSERT OR IGNORE INTO category (category_id, category_name) VALUES
 
 -- 插入示例任务数据
 INSERT OR IGNORE INTO task (title, description, deadline, priority, is_completed, category_id) VALUES
-('完成Qt课程设计', '实现一个任务管理系统', '2026-01-20 23:59', 3, 0, 2),
-('购买生活用品', '牛奶、面包、水果', '2026-01-15 10:00', 1, 0, 3),
-('编写项目文档', '整理架构图和接口说明', '2026-01-18 16:00', 2, 0, 1),
-('学习SQLite', '掌握数据库基本操作和SQL语句', '2026-01-17 20:00', 2, 1, 2),
-('看电影', '观看最新上映的科幻电影', '2026-01-16 19:30', 1, 0, 4);
+('完成Qt课程设计', '实现一个任务管理系统', CAST(strftime('%s', '2026-01-20 23:59', 'utc') AS INTEGER), 3, 0, 2),
+('购买生活用品', '牛奶、面包、水果', CAST(strftime('%s', '2026-01-15 10:00', 'utc') AS INTEGER), 1, 0, 3),
+('编写项目文档', '整理架构图和接口说明', CAST(strftime('%s', '2026-01-18 16:00', 'utc') AS INTEGER), 2, 0, 1),
+('学习SQLite', '掌握数据库基本操作和SQL语句', CAST(strftime('%s', '2026-01-17 20:00', 'utc') AS INTEGER), 2, 1, 2),
+('看电影', '观看最新上映的科幻电影', CAST(strftime('%s', '2026-01-16 19:30', 'utc') AS INTEGER), 1, 0, 4);
 
 -- 查询所有分类
 SELECT * FROM category;
@@ -0,0 +1,55 @@
+#include "exportthread.h"
+#include "fileexporter.h"
+#include "logging.h"
+
+ExportThread::ExportThread(const QString &filePath, int priority, int categoryId, int completedFilter,
+                           const CategoryDictionary &categories, QObject *parent)
+    : QThread(parent)
+    , m_repo(SqlRepository::getInstance())
+    , m_filePath(filePath)
+    , m_priority(priority)
+    , m_categoryId(categoryId)
+    , m_completedFilter(completedFilter)
+    , m_categories(categories)
+{
+}
+
+QString ExportThread::filePath() const
+{
+    return m_filePath;
+}
+
+void ExportThread::cancel()
+{
+    m_canceled.storeRelaxed(1);
+}
+
+void ExportThread::run()
+{
+    bool success = false;
+    // 总数与分块读取在同一个读事务内，保证进度总量与导出内容一致，且不会读到导出期间的修改
+    if (m_repo.beginReadTransaction()) {
+        qint64 rowsTotal = m_repo.countTasksByFilter(m_priority, m_categoryId, m_completedFilter);
+        emit exportProgress(0, rowsTotal, 0);
+
+        FileExporter exporter;
+        success = exporter.exportToCsv(m_filePath, [this](const TaskCursor &after, int limit) {
+            return m_repo.getTasksPage(m_priority, m_categoryId, m_completedFilter, after, limit);
+        }, m_categories, [this, rowsTotal](qint64 rowsWritten, qint64 bytesWritten) {
+            emit exportProgress(rowsWritten, rowsTotal, bytesWritten);
+            return !m_canceled.loadRelaxed();
+        });
+
+        m_repo.endReadTransaction();
+    }
+
+    // 取消请求在全部写完之后才到达时，导出视为成功
+    bool canceled = !success && m_canceled.loadRelaxed();
+    if (canceled) {
+        qCInfo(lcExport) << "CSV导出已取消：" << m_filePath;
+    }
+
+    // 导出完成后立即释放本线程的连接
+    m_repo.releaseThreadConnection();
+    emit exportFinished(success, canceled, m_filePath);
+}
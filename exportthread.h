@@ -0,0 +1,42 @@
+#ifndef EXPORTTHREAD_H
+#define EXPORTTHREAD_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QList>
+#include "sqlrepository.h"
+#include "categorydictionary.h"
+
+// 后台报表导出线程：使用本线程独立的连接，在一个读事务内分块读取筛选结果并流式写入CSV，
+// 导出内容对应开始时的数据库快照，导出期间界面可继续编辑任务
+class ExportThread : public QThread
+{
+    Q_OBJECT
+public:
+    // completedFilter含义同SqlRepository::getTasksByFilter（-1=全部，1=未完成，2=已完成）
+    ExportThread(const QString &filePath, int priority, int categoryId, int completedFilter,
+                 const CategoryDictionary &categories, QObject *parent = nullptr);
+
+    QString filePath() const;
+    void cancel(); // 请求取消导出（可在任意线程调用），已写入的部分文件会被删除
+
+signals:
+    // 导出进度（已写入行数/总行数，已写入字节数）
+    void exportProgress(qint64 rowsWritten, qint64 rowsTotal, qint64 bytesWritten);
+    // 导出结束（canceled为true表示被取消）
+    void exportFinished(bool success, bool canceled, const QString &filePath);
+
+protected:
+    void run() override; // 线程执行入口
+
+private:
+    SqlRepository &m_repo;
+    QString m_filePath;          // 导出文件路径
+    int m_priority;              // 筛选条件
+    int m_categoryId;
+    int m_completedFilter;
+    CategoryDictionary m_categories; // 分类字典（按值保存，线程内只读）
+    QAtomicInt m_canceled;        // 取消标志
+};
+
+#endif // EXPORTTHREAD_H
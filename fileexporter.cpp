@@ -1,78 +1,172 @@
 #include "fileexporter.h"
+#include "logging.h"
 #include <QTextStream>
 #include <QTextCodec>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <deque>
+#include <memory>
 
 FileExporter::FileExporter(QObject *parent) : QObject(parent)
 {
 }
 
-bool FileExporter::exportToCsv(const QString &filePath, const QList<Task> &tasks, const QList<Category> &categories)
+bool FileExporter::exportToCsv(const QString &filePath, const QList<Task> &tasks, const CategoryDictionary &categories)
+{
+    // 已在内存中的列表作为一个数据块输出
+    bool delivered = false;
+    return exportToCsv(filePath, [&tasks, &delivered](const TaskCursor &, int) {
+        if (delivered) {
+            return QList<Task>();
+        }
+        delivered = true;
+        return tasks;
+    }, categories);
+}
+
+bool FileExporter::exportToCsv(const QString &filePath, const ChunkFetcher &fetchChunk, const CategoryDictionary &categories,
+                               const ProgressCallback &progress)
 {
     QFile file(filePath);
     // 去掉 Qt::Text 模式，直接写字节
     if (!file.open(QIODevice::WriteOnly)) {
-        qCritical() << "CSV导出失败：无法打开文件" << filePath << "，错误：" << file.errorString();
+        qCCritical(lcExport) << "CSV导出失败：无法打开文件" << filePath << "，错误：" << file.errorString();
         return false;
     }
 
     // 兼容Qt 5/6的编码处理
     QTextCodec *codec = QTextCodec::codecForName("GBK");
     if (!codec) {
-        qCritical() << "不支持GBK编码";
-        file.close();
+        qCCritical(lcExport) << "不支持GBK编码";
+        file.remove();
         return false;
     }
 
-    // 先拼接CSV内容为QString
-    QString csvContent;
+    auto writeBytes = [&](const QByteArray &bytes) {
+        if (file.write(bytes) != bytes.size()) {
+            qCCritical(lcExport) << "CSV导出失败：写入文件出错" << filePath << "，错误：" << file.errorString();
+            return false;
+        }
+        return true;
+    };
+
     // 表头
-    csvContent += formatCsvField("任务ID") + ","
-                  + formatCsvField("标题") + ","
-                  + formatCsvField("描述") + ","
-                  + formatCsvField("截止时间") + ","
-                  + formatCsvField("优先级") + ","
-                  + formatCsvField("分类") + ","
-                  + formatCsvField("完成状态") + "\n";
-
-    // 任务数据
-    foreach (const Task &task, tasks) {
-        QString priorityStr = task.priority == 1 ? "低" : (task.priority == 2 ? "中" : "高");
-        QString statusStr = task.isCompleted ? "已完成" : "未完成";
-        QString categoryName = getCategoryNameById(task.categoryId, categories);
-
-        csvContent += formatCsvField(QString::number(task.taskId)) + ","
-                      + formatCsvField(task.title) + ","
-                      + formatCsvField(task.description) + ","
-                      + formatCsvField(task.deadline.toString("yyyy-MM-dd HH:mm:ss")) + ","
-                      + formatCsvField(priorityStr) + ","
-                      + formatCsvField(categoryName) + ","
-                      + formatCsvField(statusStr) + "\n";
+    QString header = formatCsvField("任务ID") + ","
+                     + formatCsvField("标题") + ","
+                     + formatCsvField("描述") + ","
+                     + formatCsvField("截止时间") + ","
+                     + formatCsvField("优先级") + ","
+                     + formatCsvField("分类") + ","
+                     + formatCsvField("完成状态") + "\n";
+    if (!writeBytes(codec->fromUnicode(header))) {
+        file.remove();
+        return false;
+    }
+
+    // 重排缓冲区：按提交顺序排列的编码任务，队首完成后才写入，保证输出顺序与读取顺序一致；
+    // GBK编码无状态，各块独立编码拼接后与整体编码的结果逐字节相同
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxInFlight = qMax(2, pool->maxThreadCount() * 2); // 限制在途块数，内存占用保持恒定
+    std::deque<QFuture<QByteArray>> inFlight;
+    qint64 rowsWritten = 0;
+    std::deque<int> inFlightRows; // 各在途块的行数，用于进度统计
+    auto writeFront = [&]() {
+        QByteArray bytes = inFlight.front().result();
+        inFlight.pop_front();
+        if (!writeBytes(bytes)) {
+            return false;
+        }
+        rowsWritten += inFlightRows.front();
+        inFlightRows.pop_front();
+        if (progress && !progress(rowsWritten, file.pos())) {
+            qCDebug(lcExport) << "CSV导出被取消：" << filePath;
+            return false;
+        }
+        return true;
+    };
+    // 失败或取消：等待在途编码任务结束，删除部分文件
+    auto abandon = [&]() {
+        for (QFuture<QByteArray> &future : inFlight) {
+            future.cancel();
+            future.waitForFinished();
+        }
+        file.remove();
+    };
+
+    // 任务数据：按块读取（以每块最后一行作为下一块的游标），读取的同时其他块在线程池中编码
+    TaskCursor cursor;
+    for (;;) {
+        QList<Task> chunk = fetchChunk(cursor, kChunkSize);
+        if (chunk.isEmpty()) {
+            break;
+        }
+        bool lastChunk = chunk.size() < kChunkSize;
+        cursor.deadline = chunk.last().deadline;
+        cursor.taskId = chunk.last().taskId;
+
+        inFlightRows.push_back(chunk.size());
+        inFlight.push_back(QtConcurrent::run(pool, &FileExporter::encodeChunk, codec, chunk, categories));
+        while (int(inFlight.size()) >= maxInFlight) {
+            if (!writeFront()) {
+                abandon();
+                return false;
+            }
+        }
+
+        if (lastChunk) {
+            break; // 数据源已读完
+        }
     }
 
-    // 编码为GBK字节并写入
-    QByteArray gbkData = codec->fromUnicode(csvContent);
-    file.write(gbkData);
+    while (!inFlight.empty()) {
+        if (!writeFront()) {
+            abandon();
+            return false;
+        }
+    }
     file.close();
+    qCDebug(lcExport) << "CSV导出完成：" << filePath << "，行数：" << rowsWritten;
     return true;
 }
 
-QString FileExporter::getCategoryNameById(int categoryId, const QList<Category> &categories)
+QByteArray FileExporter::encodeChunk(QTextCodec *codec, const QList<Task> &tasks, const CategoryDictionary &categories)
 {
-    foreach (const Category &cat, categories) {
-        if (cat.categoryId == categoryId) {
-            return cat.categoryName;
-        }
+    QString text;
+    for (const Task &task : tasks) {
+        QString priorityStr = task.priority == 1 ? "低" : (task.priority == 2 ? "中" : "高");
+        QString statusStr = task.isCompleted ? "已完成" : "未完成";
+        QString categoryName = categories.name(task.categoryId, "未知分类");
+
+        text += formatCsvField(QString::number(task.taskId)) + ","
+                + formatCsvField(task.title) + ","
+                + formatCsvField(task.description) + ","
+                + formatCsvField(task.deadline.toString("yyyy-MM-dd HH:mm:ss")) + ","
+                + formatCsvField(priorityStr) + ","
+                + formatCsvField(categoryName) + ","
+                + formatCsvField(statusStr) + "\n";
     }
-    return "未知分类";
+
+    // 编码器不能跨线程共享，每块创建自己的编码器
+    std::unique_ptr<QTextEncoder> encoder(codec->makeEncoder());
+    return encoder->fromUnicode(text);
 }
 
 QString FileExporter::formatCsvField(const QString &text)
 {
     // CSV规则：字段包含逗号、双引号或换行符时，需用双引号包裹；双引号需替换为两个双引号
-    QString formatted = text;
-    if (formatted.contains(",") || formatted.contains("\"") || formatted.contains("\n")) {
-        formatted.replace("\"", "\"\""); // 双引号转义
-        formatted = "\"" + formatted + "\""; // 包裹双引号
+    // 一次扫描判断是否需要转义，大多数字段无需转义，直接返回（共享数据，不复制）
+    bool needsQuoting = false;
+    for (QChar ch : text) {
+        if (ch == QLatin1Char(',') || ch == QLatin1Char('"') || ch == QLatin1Char('\n')) {
+            needsQuoting = true;
+            break;
+        }
+    }
+    if (!needsQuoting) {
+        return text;
     }
-    return formatted;
+
+    QString formatted = text;
+    formatted.replace("\"", "\"\""); // 双引号转义
+    return "\"" + formatted + "\""; // 包裹双引号
 }
@@ -5,7 +5,10 @@
 #include <QFile>
 #include <QTextStream>
 #include <QList>
+#include <QTextCodec>
+#include <functional>
 #include "sqlrepository.h"
+#include "categorydictionary.h"
 
 class FileExporter : public QObject
 {
@@ -13,14 +16,25 @@ class FileExporter : public QObject
 public:
     explicit FileExporter(QObject *parent = nullptr);
 
+    // 分块数据源：返回游标after之后按(截止时间, 任务ID)排序的最多limit条任务，没有更多时返回空列表
+    using ChunkFetcher = std::function<QList<Task>(const TaskCursor &after, int limit)>;
+    // 进度回调：每写入一块后调用，返回false表示取消导出
+    using ProgressCallback = std::function<bool(qint64 rowsWritten, qint64 bytesWritten)>;
+
     // 导出任务列表到CSV文件（支持中文编码）
-    bool exportToCsv(const QString &filePath, const QList<Task> &tasks, const QList<Category> &categories);
+    bool exportToCsv(const QString &filePath, const QList<Task> &tasks, const CategoryDictionary &categories);
+    // 流式导出：按块读取任务，在线程池中并行格式化并编码为GBK，按读取顺序写入文件，
+    // 输出与单线程逐行编码完全一致，内存占用与导出行数无关；失败或取消时删除已写入的部分文件
+    bool exportToCsv(const QString &filePath, const ChunkFetcher &fetchChunk, const CategoryDictionary &categories,
+                     const ProgressCallback &progress = nullptr);
 
 private:
-    // 根据分类ID获取分类名称
-    QString getCategoryNameById(int categoryId, const QList<Category> &categories);
+    static constexpr int kChunkSize = 1000; // 每次从数据源读取、并作为一个并行编码单元的任务数
+
+    // 将一块任务格式化为CSV文本并编码为GBK（在线程池中执行，每块使用独立的编码器）
+    static QByteArray encodeChunk(QTextCodec *codec, const QList<Task> &tasks, const CategoryDictionary &categories);
     // 处理CSV字段中的特殊字符（如逗号、双引号）
-    QString formatCsvField(const QString &text);
+    static QString formatCsvField(const QString &text);
 };
 
 #endif // FILEEXPORTER_H
@@ -0,0 +1,372 @@
+#include "fileimporter.h"
+#include "logging.h"
+#include <QFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <deque>
+#include <memory>
+
+FileImporter::FileImporter(QObject *parent) : QObject(parent)
+{
+}
+
+CsvImportResult FileImporter::importFromCsv(const QString &filePath, const CategoryDictionary &categories,
+                                            const BatchSink &insertBatch, const ProgressCallback &progress)
+{
+    CsvImportResult result;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCCritical(lcImport) << "CSV导入失败：无法打开文件" << filePath << "，错误：" << file.errorString();
+        return result;
+    }
+
+    // 整个文件映射到内存，各解析任务直接读取映射区，不复制文件内容
+    const qint64 fileSize = file.size();
+    QByteArray buffer;
+    const char *data = nullptr;
+    if (fileSize > 0) {
+        data = reinterpret_cast<const char *>(file.map(0, fileSize));
+        if (!data) {
+            // 不支持映射的文件（如管道）退回整体读取
+            buffer = file.readAll();
+            data = buffer.constData();
+        }
+    }
+    const qsizetype size = data ? qsizetype(fileSize) : 0;
+
+    // 编码识别：UTF-8 BOM，或抽样内容为合法UTF-8（GBK中文几乎不可能恰好构成合法UTF-8）时按UTF-8解析
+    qsizetype pos = 0;
+    QTextCodec *codec = nullptr;
+    if (size >= 3 && uchar(data[0]) == 0xEF && uchar(data[1]) == 0xBB && uchar(data[2]) == 0xBF) {
+        pos = 3;
+    } else if (!isValidUtf8(data, qMin(size, qsizetype(64 * 1024)))) {
+        codec = QTextCodec::codecForName("GBK");
+        if (!codec) {
+            qCCritical(lcImport) << "不支持GBK编码";
+            return result;
+        }
+    }
+    qCDebug(lcImport) << "CSV导入：" << filePath << "，编码：" << (codec ? "GBK" : "UTF-8") << "，字节数：" << size;
+
+    // 跳过表头
+    qint64 line = 1;
+    pos = skipRecord(data, size, pos, &line);
+
+    // 重排缓冲区（同FileExporter）：按文件顺序排列的解析任务，队首完成后才合并写入，
+    // 写库顺序与文件顺序一致；限制在途块数，内存占用与文件大小无关
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxInFlight = qMax(2, pool->maxThreadCount() * 2);
+    std::deque<QFuture<ParsedChunk>> inFlight;
+    std::deque<qsizetype> inFlightEnds; // 各在途块的结束位置，用于进度统计
+    QList<Task> batch;
+    batch.reserve(kInsertBatchSize);
+    qsizetype bytesProcessed = 0;
+
+    auto flushBatch = [&]() {
+        if (batch.isEmpty()) {
+            return true;
+        }
+        if (!insertBatch(batch)) {
+            qCCritical(lcImport) << "CSV导入失败：写入数据库出错，已导入" << result.rowsImported << "行";
+            return false;
+        }
+        result.rowsImported += batch.size();
+        batch.clear();
+        if (progress && !progress(result.rowsImported, bytesProcessed, size)) {
+            qCDebug(lcImport) << "CSV导入被取消：" << filePath;
+            return false;
+        }
+        return true;
+    };
+    auto takeFront = [&]() {
+        ParsedChunk chunk = inFlight.front().result();
+        inFlight.pop_front();
+        bytesProcessed = inFlightEnds.front();
+        inFlightEnds.pop_front();
+
+        result.rowsRejected += chunk.errors.size();
+        for (const CsvImportError &error : chunk.errors) {
+            if (result.errors.size() >= kMaxReportedErrors) {
+                break;
+            }
+            result.errors.append(error);
+        }
+        batch.append(chunk.tasks);
+        return batch.size() < kInsertBatchSize || flushBatch();
+    };
+    // 失败或取消：等待在途解析任务结束（它们引用着映射内存）
+    auto abandon = [&]() {
+        for (QFuture<ParsedChunk> &future : inFlight) {
+            future.cancel();
+            future.waitForFinished();
+        }
+    };
+
+    // 顺序扫描切块：只识别引号和换行（GBK与UTF-8的多字节字符都不含这两个字节），
+    // 在达到目标大小后的第一个记录边界处切分，同时统计每块的起始行号
+    while (pos < size) {
+        qsizetype chunkStart = pos;
+        qint64 chunkLine = line;
+        qsizetype target = chunkStart + kChunkBytes;
+        while (pos < size && pos < target) {
+            pos = skipRecord(data, size, pos, &line);
+        }
+
+        inFlightEnds.push_back(pos);
+        inFlight.push_back(QtConcurrent::run(pool, &FileImporter::parseChunk, codec, data + chunkStart,
+                                             pos - chunkStart, chunkLine, categories));
+        while (int(inFlight.size()) >= maxInFlight) {
+            if (!takeFront()) {
+                abandon();
+                return result;
+            }
+        }
+    }
+
+    while (!inFlight.empty()) {
+        if (!takeFront()) {
+            abandon();
+            return result;
+        }
+    }
+    if (!flushBatch()) {
+        return result;
+    }
+
+    result.success = true;
+    qCDebug(lcImport) << "CSV导入完成：" << filePath << "，导入：" << result.rowsImported
+                      << "，跳过：" << result.rowsRejected;
+    return result;
+}
+
+FileImporter::ParsedChunk FileImporter::parseChunk(QTextCodec *codec, const char *data, qsizetype size, qint64 firstLine,
+                                                   const CategoryDictionary &categories)
+{
+    // 块以完整记录为边界，GBK无跨块状态，可独立解码；解码器不能跨线程共享，每块创建自己的解码器
+    QString text;
+    if (codec) {
+        std::unique_ptr<QTextDecoder> decoder(codec->makeDecoder());
+        text = decoder->toUnicode(data, int(size));
+    } else {
+        text = QString::fromUtf8(data, size);
+    }
+
+    ParsedChunk chunk;
+    const QChar *p = text.constData();
+    const QChar *end = p + text.size();
+    qint64 line = firstLine;
+    QStringList fields;
+
+    while (p < end) {
+        const qint64 recordLine = line;
+        QString error;
+        fields.clear();
+
+        // 按CSV规则拆分一条记录的字段：双引号包裹的字段可包含逗号、换行，""表示一个双引号
+        for (;;) {
+            QString field;
+            if (p < end && *p == QLatin1Char('"')) {
+                ++p;
+                const QChar *start = p;
+                bool closed = false;
+                while (p < end) {
+                    if (*p == QLatin1Char('"')) {
+                        field.append(start, p - start);
+                        ++p;
+                        if (p < end && *p == QLatin1Char('"')) {
+                            start = p++; // 转义的双引号，保留一个
+                            continue;
+                        }
+                        closed = true;
+                        break;
+                    }
+                    if (*p == QLatin1Char('\n')) {
+                        ++line;
+                    }
+                    ++p;
+                }
+                if (!closed) {
+                    field.append(start, p - start);
+                    error = "引号未闭合";
+                }
+                // 闭合引号后只能是分隔符或行尾
+                if (p < end && *p != QLatin1Char(',') && *p != QLatin1Char('\r') && *p != QLatin1Char('\n')) {
+                    error = "引号字段后存在多余字符";
+                    while (p < end && *p != QLatin1Char(',') && *p != QLatin1Char('\n')) {
+                        ++p;
+                    }
+                }
+                if (p < end && *p == QLatin1Char('\r')) {
+                    ++p;
+                }
+            } else {
+                const QChar *start = p;
+                while (p < end && *p != QLatin1Char(',') && *p != QLatin1Char('\n')) {
+                    ++p;
+                }
+                const QChar *fieldEnd = p;
+                if (fieldEnd > start && fieldEnd[-1] == QLatin1Char('\r')) {
+                    --fieldEnd; // CRLF行尾
+                }
+                field = QString(start, fieldEnd - start);
+            }
+            fields.append(field);
+
+            if (p < end && *p == QLatin1Char(',')) {
+                ++p;
+                continue;
+            }
+            if (p < end) {
+                ++p; // 换行符
+                ++line;
+            }
+            break;
+        }
+
+        if (fields.size() == 1 && fields.first().isEmpty()) {
+            continue; // 空行
+        }
+        Task task;
+        if (error.isEmpty() && recordToTask(fields, categories, &task, &error)) {
+            chunk.tasks.append(task);
+        } else {
+            chunk.errors.append(CsvImportError{recordLine, error});
+        }
+    }
+    return chunk;
+}
+
+bool FileImporter::recordToTask(const QStringList &fields, const CategoryDictionary &categories, Task *task, QString *error)
+{
+    // 列顺序：任务ID,标题,描述,截止时间,优先级,分类,完成状态
+    if (fields.size() != 7) {
+        *error = QString("字段数为%1，应为7").arg(fields.size());
+        return false;
+    }
+
+    task->taskId = -1;
+    task->title = fields.at(1);
+    if (task->title.trimmed().isEmpty()) {
+        *error = "标题为空";
+        return false;
+    }
+    task->description = fields.at(2);
+
+    task->deadline = parseDeadline(fields.at(3));
+    if (!task->deadline.isValid()) {
+        *error = QString("无法识别的截止时间：%1").arg(fields.at(3));
+        return false;
+    }
+
+    const QString &priority = fields.at(4);
+    if (priority == "低" || priority == "1") {
+        task->priority = 1;
+    } else if (priority == "中" || priority == "2") {
+        task->priority = 2;
+    } else if (priority == "高" || priority == "3") {
+        task->priority = 3;
+    } else {
+        *error = QString("无法识别的优先级：%1").arg(priority);
+        return false;
+    }
+
+    task->categoryId = categories.id(fields.at(5));
+    if (task->categoryId == -1) {
+        *error = QString("分类不存在：%1").arg(fields.at(5));
+        return false;
+    }
+
+    const QString &status = fields.at(6);
+    if (status == "已完成" || status == "1") {
+        task->isCompleted = true;
+    } else if (status == "未完成" || status == "0") {
+        task->isCompleted = false;
+    } else {
+        *error = QString("无法识别的完成状态：%1").arg(status);
+        return false;
+    }
+    return true;
+}
+
+QDateTime FileImporter::parseDeadline(const QString &text)
+{
+    // 快速路径：导出格式yyyy-MM-dd HH:mm:ss，逐位解析，避免按格式串解析的开销
+    if (text.size() == 19 && text.at(4) == QLatin1Char('-') && text.at(7) == QLatin1Char('-')
+        && text.at(10) == QLatin1Char(' ') && text.at(13) == QLatin1Char(':') && text.at(16) == QLatin1Char(':')) {
+        bool digitsOk = true;
+        auto number = [&](int pos, int length) {
+            int value = 0;
+            for (int i = pos; i < pos + length; ++i) {
+                ushort c = text.at(i).unicode();
+                if (c < '0' || c > '9') {
+                    digitsOk = false;
+                    return 0;
+                }
+                value = value * 10 + (c - '0');
+            }
+            return value;
+        };
+        QDate date(number(0, 4), number(5, 2), number(8, 2));
+        QTime time(number(11, 2), number(14, 2), number(17, 2));
+        if (digitsOk && date.isValid() && time.isValid()) {
+            return QDateTime(date, time);
+        }
+        return QDateTime();
+    }
+
+    QDateTime deadline = QDateTime::fromString(text, "yyyy-MM-dd HH:mm");
+    if (!deadline.isValid()) {
+        deadline = QDateTime::fromString(text, Qt::ISODate);
+    }
+    return deadline;
+}
+
+bool FileImporter::isValidUtf8(const char *data, qsizetype size)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    const uchar *end = p + size;
+    while (p < end) {
+        uchar c = *p;
+        int trailing;
+        if (c < 0x80) {
+            ++p;
+            continue;
+        } else if (c >= 0xC2 && c <= 0xDF) {
+            trailing = 1;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            trailing = 2;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            trailing = 3;
+        } else {
+            return false;
+        }
+        if (end - p <= trailing) {
+            return true; // 样本末尾被截断的字符
+        }
+        for (int i = 1; i <= trailing; ++i) {
+            if ((p[i] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        p += trailing + 1;
+    }
+    return true;
+}
+
+qsizetype FileImporter::skipRecord(const char *data, qsizetype size, qsizetype pos, qint64 *lines)
+{
+    // ""转义会切换两次引号状态，不影响结果
+    bool inQuotes = false;
+    while (pos < size) {
+        char c = data[pos++];
+        if (c == '"') {
+            inQuotes = !inQuotes;
+        } else if (c == '\n') {
+            ++*lines;
+            if (!inQuotes) {
+                break;
+            }
+        }
+    }
+    return pos;
+}
@@ -0,0 +1,69 @@
+#ifndef FILEIMPORTER_H
+#define FILEIMPORTER_H
+
+#include <QObject>
+#include <QList>
+#include <QTextCodec>
+#include <functional>
+#include "sqlrepository.h"
+#include "categorydictionary.h"
+
+// 导入时被拒绝的一行
+struct CsvImportError {
+    qint64 lineNumber;   // 该记录在文件中的起始行号（从1开始，表头为第1行）
+    QString message;     // 拒绝原因
+};
+
+// CSV导入结果
+struct CsvImportResult {
+    bool success = false;          // 文件读取与写库是否全部成功（被拒绝的行不影响）
+    qint64 rowsImported = 0;       // 已写入数据库的任务数
+    qint64 rowsRejected = 0;       // 格式错误被跳过的行数
+    QList<CsvImportError> errors;  // 被拒绝的行（最多记录kMaxReportedErrors条）
+};
+
+class FileImporter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FileImporter(QObject *parent = nullptr);
+
+    // 写入回调：按文件顺序交付一批解析好的任务（taskId无效），返回false表示写库失败并中止导入
+    using BatchSink = std::function<bool(const QList<Task> &tasks)>;
+    // 进度回调：每写入一批后调用（已导入行数/已处理字节数/文件总字节数），返回false表示取消导入
+    using ProgressCallback = std::function<bool(qint64 rowsImported, qint64 bytesProcessed, qint64 bytesTotal)>;
+
+    static constexpr int kMaxReportedErrors = 100; // 结果中最多记录的错误行数
+
+    // 从CSV文件导入任务，格式与FileExporter导出的一致（第一行为表头，任务ID列被忽略，写库时分配新ID）。
+    // 文件编码自动识别：带BOM或内容为合法UTF-8时按UTF-8解析，否则按GBK解析。
+    // 文件按完整记录（引号内的换行不作为切分点）切块后在线程池中并行解码和解析，
+    // 解析结果按文件顺序合并成大批次交给insertBatch写库；格式错误的行被跳过并记录行号。
+    // 写库失败或取消时中止，此前已写入的批次保留（result->rowsImported为已写入数）
+    CsvImportResult importFromCsv(const QString &filePath, const CategoryDictionary &categories,
+                                  const BatchSink &insertBatch, const ProgressCallback &progress = nullptr);
+
+private:
+    static constexpr qsizetype kChunkBytes = 1 << 20; // 每个并行解析单元的目标字节数（在记录边界处切分）
+    static constexpr int kInsertBatchSize = 20000;    // 每批（一个事务）写入的任务数
+
+    // 一块数据的解析结果
+    struct ParsedChunk {
+        QList<Task> tasks;
+        QList<CsvImportError> errors;
+    };
+
+    // 解码并解析一块完整记录（在线程池中执行）；codec为nullptr表示UTF-8，firstLine为块首行的行号
+    static ParsedChunk parseChunk(QTextCodec *codec, const char *data, qsizetype size, qint64 firstLine,
+                                  const CategoryDictionary &categories);
+    // 将一条记录的字段转换为任务，失败时返回false并写入错误原因
+    static bool recordToTask(const QStringList &fields, const CategoryDictionary &categories, Task *task, QString *error);
+    // 解析截止时间（导出格式yyyy-MM-dd HH:mm:ss走快速路径，另接受yyyy-MM-dd HH:mm和ISO格式）
+    static QDateTime parseDeadline(const QString &text);
+    // 抽样判断数据是否为合法UTF-8（末尾被截断的多字节字符不视为错误）
+    static bool isValidUtf8(const char *data, qsizetype size);
+    // 从pos开始跳过一条完整记录（引号内的换行不结束记录），返回下一条记录的起始位置，lines累加跨过的换行数
+    static qsizetype skipRecord(const char *data, qsizetype size, qsizetype pos, qint64 *lines);
+};
+
+#endif // FILEIMPORTER_H
@@ -0,0 +1,10 @@
+#include "logging.h"
+
+// 默认只输出info及以上级别，debug日志需按分类显式开启
+Q_LOGGING_CATEGORY(lcSql, "taskmanager.sql", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcSqlRow, "taskmanager.sql.row", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcSqlDiagnostics, "taskmanager.sql.diagnostics", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcReminder, "taskmanager.reminder", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcExport, "taskmanager.export", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcImport, "taskmanager.import", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcStartup, "taskmanager.startup", QtInfoMsg)
@@ -0,0 +1,26 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+
+// 日志分类：debug级别默认关闭，运行时可通过环境变量QT_LOGGING_RULES开启，例如
+//   QT_LOGGING_RULES="taskmanager.sql.debug=true"      数据库访问日志
+//   QT_LOGGING_RULES="taskmanager.*.debug=true"        全部调试日志
+//   QT_LOGGING_RULES="taskmanager.sql.diagnostics.debug=true"  启动时执行数据库诊断查询
+Q_DECLARE_LOGGING_CATEGORY(lcSql)      // taskmanager.sql：数据库连接、迁移与查询
+Q_DECLARE_LOGGING_CATEGORY(lcSqlRow)   // taskmanager.sql.row：查询结果逐行跟踪（仅调试构建）
+Q_DECLARE_LOGGING_CATEGORY(lcSqlDiagnostics) // taskmanager.sql.diagnostics：启动诊断查询（开启后才执行）
+Q_DECLARE_LOGGING_CATEGORY(lcReminder) // taskmanager.reminder：提醒线程
+Q_DECLARE_LOGGING_CATEGORY(lcExport)   // taskmanager.export：报表导出
+Q_DECLARE_LOGGING_CATEGORY(lcImport)   // taskmanager.import：CSV导入
+Q_DECLARE_LOGGING_CATEGORY(lcStartup)  // taskmanager.startup：启动耗时（info级别，默认输出）
+
+// 逐行跟踪日志：调试构建中等同qCDebug(lcSqlRow)；
+// 发布构建中整条语句（包括参数求值）被编译器完全移除，大结果集不为诊断付出任何开销
+#ifdef QT_DEBUG
+#  define qCTraceRow() qCDebug(lcSqlRow)
+#else
+#  define qCTraceRow() while (false) qCDebug(lcSqlRow)
+#endif
+
+#endif // LOGGING_H
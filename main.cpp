@@ -1,9 +1,14 @@
 #include <QApplication>
 #include <QStyleFactory>
+#include <QElapsedTimer>
 #include "mainwindow.h"
 
 int main(int argc, char *argv[])
 {
+    // 启动计时：从进程入口到任务列表首次绘制
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     QApplication a(argc, argv);
 
     // 设置应用程序属性（兼容Qt 5/6）
@@ -13,6 +18,7 @@ int main(int argc, char *argv[])
 
     // 启动主窗口
     MainWindow w;
+    w.measureStartup(startupTimer);
     w.show();
 
     return a.exec();
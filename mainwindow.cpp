@@ -1,4 +1,5 @@
 #include "mainwindow.h"
+#include "logging.h"
 #include <QCoreApplication>
 
 MainWindow::MainWindow(QWidget *parent)
@@ -7,35 +8,132 @@ MainWindow::MainWindow(QWidget *parent)
     , m_taskModel(new TaskModel(this))
     , m_addTaskDialog(new AddTaskDialog(this))
     , m_categoryDialog(new CategoryDialog(this))
+    , m_searchWatcher(new QFutureWatcher<TaskSearchResult>(this))
+    , m_statisticsWatcher(new QFutureWatcher<TaskStatistics>(this))
+    , m_importWatcher(new QFutureWatcher<CsvImportResult>(this))
 {
     initUI(); // 初始化整体UI
 
-    // 更新任务完成率的函数
-    auto updateTaskCompletionRate = [=]() {
-        int totalTasks = 0;
-        int completedTasks = 0;
-        m_taskManager->getTaskStatistics(totalTasks, completedTasks);
-        
+    // 统计在数据库工作线程上计算，完成后更新状态栏
+    connect(m_statisticsWatcher, &QFutureWatcherBase::finished, this, [=]() {
+        if (m_statisticsWatcher->isCanceled()) {
+            return; // 已被更新的统计请求取代
+        }
+        TaskCounts counts = m_statisticsWatcher->result().overall;
+
         QString statusText;
-        if (totalTasks > 0) {
-            double completionRate = (double)completedTasks / totalTasks * 100;
-            statusText = QString(tr("任务完成率：%1% (%2/%3) | 数据库连接正常")).arg(completionRate, 0, 'f', 1).arg(completedTasks).arg(totalTasks);
+        if (counts.total > 0) {
+            double completionRate = (double)counts.completed / counts.total * 100;
+            statusText = QString(tr("任务完成率：%1% (%2/%3) | 已逾期：%4 | 数据库连接正常"))
+                             .arg(completionRate, 0, 'f', 1).arg(counts.completed).arg(counts.total).arg(counts.overdue);
         } else {
             statusText = tr("暂无任务 | 数据库连接正常");
         }
         
         statusBar()->showMessage(statusText);
+    });
+
+    // 更新任务完成率的函数
+    auto updateTaskCompletionRate = [=]() {
+        m_statisticsWatcher->setFuture(m_taskManager->getTaskStatisticsBreakdownAsync());
     };
-    
-    // 连接任务变化信号（刷新表格并更新完成率）
-    connect(m_taskManager, &TaskManager::tasksChanged, this, [=](const QList<Task> &tasks) {
-        m_taskModel->setTasks(tasks, m_taskManager->getCategories());
+
+    // 连接任务变化信号（按当前筛选条件刷新表格并更新完成率）
+    connect(m_taskManager, &TaskManager::tasksChanged, this, [=]() {
+        onFilterChanged();
+        updateTaskCompletionRate();
+    });
+    // 单个任务变化时逐行更新表格，保留选中和滚动位置
+    connect(m_taskManager, &TaskManager::taskInserted, this, [=](const Task &task) {
+        m_taskModel->insertTask(task);
+        updateTaskCompletionRate();
+    });
+    connect(m_taskManager, &TaskManager::taskUpdated, this, [=](const Task &task, const Task &previous) {
+        m_taskModel->updateTask(task, previous);
+        updateTaskCompletionRate();
+    });
+    connect(m_taskManager, &TaskManager::taskRemoved, this, [=](const Task &task) {
+        m_taskModel->removeTask(task);
         updateTaskCompletionRate();
     });
     
     // 程序启动时更新一次完成率
     updateTaskCompletionRate();
 
+    // 连接后台备份进度与结果信号
+    connect(m_taskManager, &TaskManager::backupProgress, this, [=](qint64 bytesWritten, qint64 bytesTotal) {
+        if (!m_backupProgressDialog) {
+            return;
+        }
+        m_backupProgressDialog->setValue(bytesTotal > 0 ? int(bytesWritten * 1000 / bytesTotal) : 0);
+        m_backupProgressDialog->setLabelText(tr("已备份 %1 / %2 KB").arg(bytesWritten / 1024).arg(bytesTotal / 1024));
+    });
+    connect(m_taskManager, &TaskManager::backupFinished, this, [=](bool success, bool canceled, const QString &backupPath) {
+        if (m_backupProgressDialog) {
+            m_backupProgressDialog->deleteLater();
+            m_backupProgressDialog = nullptr;
+        }
+        if (canceled) {
+            statusBar()->showMessage(tr("数据库备份已取消"), 3000);
+        } else if (success) {
+            QMessageBox::information(this, tr("成功"), tr("数据库备份成功！\n备份路径：%1").arg(backupPath));
+        } else {
+            QMessageBox::critical(this, tr("失败"), tr("数据库备份失败，请检查路径权限或数据库连接！"));
+        }
+    });
+
+    // 搜索结果返回后更新任务列表
+    connect(m_searchWatcher, &QFutureWatcherBase::finished, this, [=]() {
+        if (m_searchWatcher->isCanceled()) {
+            return; // 已被新的搜索或筛选取代
+        }
+        TaskSearchResult result = m_searchWatcher->result();
+        m_taskModel->setTasks(result.tasks, m_taskManager->categoryDictionary(), result.snippets);
+        statusBar()->showMessage(QString(tr("搜索结果：找到 %1 条匹配任务")).arg(result.tasks.size()), 3000);
+    });
+
+    // 连接后台导出进度与结果信号
+    connect(m_taskManager, &TaskManager::exportProgress, this, [=](qint64 rowsWritten, qint64 rowsTotal, qint64 bytesWritten) {
+        if (!m_exportProgressDialog) {
+            return;
+        }
+        // 进度按千分比显示，避免行数超出int范围
+        m_exportProgressDialog->setValue(rowsTotal > 0 ? int(rowsWritten * 1000 / rowsTotal) : 0);
+        m_exportProgressDialog->setLabelText(tr("已导出 %1 / %2 行（%3 KB）")
+                                             .arg(rowsWritten).arg(rowsTotal).arg(bytesWritten / 1024));
+    });
+    connect(m_taskManager, &TaskManager::exportFinished, this, [=](bool success, bool canceled, const QString &filePath) {
+        if (m_exportProgressDialog) {
+            m_exportProgressDialog->deleteLater();
+            m_exportProgressDialog = nullptr;
+        }
+        if (canceled) {
+            statusBar()->showMessage(tr("报表导出已取消"), 3000);
+        } else if (success) {
+            QMessageBox::information(this, tr("导出成功"), tr("报表已导出至：\n%1").arg(filePath));
+        } else {
+            QMessageBox::critical(this, tr("导出失败"), tr("无法导出报表，请检查文件路径权限！"));
+        }
+    });
+
+    // CSV导入完成后提示导入结果（被跳过的行列出行号）
+    connect(m_importWatcher, &QFutureWatcherBase::finished, this, [=]() {
+        CsvImportResult result = m_importWatcher->result();
+        QString message = tr("已导入 %1 个任务，跳过 %2 行。").arg(result.rowsImported).arg(result.rowsRejected);
+        const int maxListedErrors = 10;
+        for (int i = 0; i < result.errors.size() && i < maxListedErrors; ++i) {
+            message += tr("\n第 %1 行：%2").arg(result.errors.at(i).lineNumber).arg(result.errors.at(i).message);
+        }
+        if (result.rowsRejected > maxListedErrors) {
+            message += tr("\n……");
+        }
+        if (result.success) {
+            QMessageBox::information(this, tr("导入完成"), message);
+        } else {
+            QMessageBox::critical(this, tr("导入失败"), tr("导入中止，请检查文件或数据库连接！\n") + message);
+        }
+    });
+
     // 连接分类变化信号（刷新下拉框）
     connect(m_taskManager, &TaskManager::categoriesChanged, this, &MainWindow::loadCategoriesToComboBox);
 
@@ -88,6 +186,25 @@ MainWindow::~MainWindow()
     delete m_systemTrayIcon;
 }
 
+void MainWindow::measureStartup(const QElapsedTimer &startupTimer)
+{
+    m_startupTimer = startupTimer;
+    m_tableView->viewport()->installEventFilter(this);
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_tableView->viewport() && event->type() == QEvent::Paint && m_startupTimer.isValid()) {
+        // 事件过滤器在绘制之前调用，排队到绘制完成后再记录耗时
+        m_tableView->viewport()->removeEventFilter(this);
+        QMetaObject::invokeMethod(this, [this]() {
+            qCInfo(lcStartup) << "启动耗时（进程启动到任务列表首次绘制）：" << m_startupTimer.elapsed() << "ms";
+            m_startupTimer.invalidate();
+        }, Qt::QueuedConnection);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
 void MainWindow::initUI()
 {
     // 设置窗口基本属性
@@ -128,6 +245,7 @@ void MainWindow::initToolBar()
     QAction *actBackup = new QAction(QIcon::fromTheme("document-save-as"), tr("备份数据"), this);
     QAction *actRestore = new QAction(QIcon::fromTheme("document-open"), tr("恢复数据"), this);
     QAction *actExport = new QAction(QIcon::fromTheme("document-export"), tr("导出报表"), this);
+    QAction *actImport = new QAction(QIcon::fromTheme("document-import"), tr("导入任务"), this);
 
     // 连接按钮信号
     connect(actAdd, &QAction::triggered, this, &MainWindow::onAddTaskClicked);
@@ -138,6 +256,7 @@ void MainWindow::initToolBar()
     connect(actBackup, &QAction::triggered, this, &MainWindow::onBackupDatabaseClicked);
     connect(actRestore, &QAction::triggered, this, &MainWindow::onRestoreDatabaseClicked);
     connect(actExport, &QAction::triggered, this, &MainWindow::onExportCsvClicked);
+    connect(actImport, &QAction::triggered, this, &MainWindow::onImportCsvClicked);
 
     // 添加到工具栏
     m_toolBar->addAction(actAdd);
@@ -151,6 +270,7 @@ void MainWindow::initToolBar()
     m_toolBar->addAction(actRestore);
     m_toolBar->addSeparator(); // 分隔线
     m_toolBar->addAction(actExport);
+    m_toolBar->addAction(actImport);
 }
 
 void MainWindow::initFilterWidget()
@@ -175,6 +295,7 @@ void MainWindow::initFilterWidget()
     // 完成状态筛选
     m_cmbCompleted = new QComboBox(this);
     m_cmbCompleted->addItems({tr("全部状态"), tr("未完成"), tr("已完成")});
+    m_cmbCompleted->setCurrentIndex(1); // 启动时默认只显示未完成任务
     filterLayout->addWidget(new QLabel(tr("完成状态：")));
     filterLayout->addWidget(m_cmbCompleted);
 
@@ -186,6 +307,13 @@ void MainWindow::initFilterWidget()
     
     m_btnSearch = new QPushButton(tr("搜索"), this);
     connect(m_btnSearch, &QPushButton::clicked, this, &MainWindow::onSearchClicked);
+    // 边输入边搜索：连续按键只在停顿后搜索一次
+    m_searchDebounceTimer = new QTimer(this);
+    m_searchDebounceTimer->setSingleShot(true);
+    m_searchDebounceTimer->setInterval(kSearchDebounceMs);
+    connect(m_searchDebounceTimer, &QTimer::timeout, this, &MainWindow::onSearchClicked);
+    connect(m_leSearch, &QLineEdit::textEdited, this, &MainWindow::onSearchTextEdited);
+    connect(m_leSearch, &QLineEdit::returnPressed, this, &MainWindow::onSearchClicked);
     filterLayout->addWidget(m_btnSearch);
 
     // 重置筛选按钮
@@ -211,6 +339,17 @@ void MainWindow::initTableView()
     m_tableView->verticalHeader()->setVisible(false); // 隐藏行号
     m_tableView->setAlternatingRowColors(true); // 隔行变色
 
+    // 点击表头排序（默认截止时间升序）；排序由内存任务库的有序索引完成，不在视图层重排
+    QHeaderView *header = m_tableView->horizontalHeader();
+    header->setSortIndicator(TaskModel::Column_Deadline, Qt::AscendingOrder);
+    m_tableView->setSortingEnabled(true);
+    connect(header, &QHeaderView::sortIndicatorChanged, this, [=](int section, Qt::SortOrder) {
+        if (!TaskModel::isSortableColumn(section)) {
+            // 描述列不支持排序，恢复原有的排序标记
+            header->setSortIndicator(m_taskModel->sortColumn(), m_taskModel->sortOrder());
+        }
+    });
+
     // 添加双击编辑功能
     connect(m_tableView, &QTableView::doubleClicked, this, &MainWindow::onEditTaskClicked);
 }
@@ -235,7 +374,7 @@ void MainWindow::onAddTaskClicked()
     m_addTaskDialog->setCategories(m_taskManager->getCategories()); // 设置分类列表
     if (m_addTaskDialog->exec() == QDialog::Accepted) {
         Task newTask = m_addTaskDialog->getTask();
-        m_taskManager->addTask(newTask);
+        m_taskManager->addTaskAsync(newTask); // 在数据库工作线程写入，完成后taskInserted插入一行
         loadCategoriesToComboBox(); // 新增任务后刷新分类列表
     }
 }
@@ -262,7 +401,7 @@ void MainWindow::onEditTaskClicked()
     if (m_addTaskDialog->exec() == QDialog::Accepted) {
         Task editedTask = m_addTaskDialog->getTask();
         editedTask.taskId = taskId;
-        m_taskManager->editTask(editedTask);
+        m_taskManager->editTaskAsync(editedTask);
         loadCategoriesToComboBox(); // 编辑任务后刷新分类列表
     }
 }
@@ -282,7 +421,7 @@ void MainWindow::onDeleteTaskClicked()
     }
 
     int taskId = m_taskModel->getTaskId(selectedIndex.row());
-    m_taskManager->deleteTask(taskId);
+    m_taskManager->deleteTaskAsync(taskId);
 }
 
 void MainWindow::onMarkCompletedClicked()
@@ -294,8 +433,7 @@ void MainWindow::onMarkCompletedClicked()
     }
 
     int taskId = m_taskModel->getTaskId(selectedIndex.row());
-    m_taskManager->markTaskCompleted(taskId, true);
-    onFilterChanged(); // 标记完成后立即刷新筛选结果
+    m_taskManager->markTaskCompletedAsync(taskId, true); // 成功后taskUpdated按当前筛选条件更新或移出该行
 }
 
 void MainWindow::onExportCsvClicked()
@@ -310,19 +448,42 @@ void MainWindow::onExportCsvClicked()
         filePath += ".csv";
     }
 
-    // 获取当前筛选的任务列表
+    // 当前筛选条件
     int priority = m_cmbPriority->currentIndex() - 1; // 0=全部(-1),1=低(1),2=中(2),3=高(3)
     int categoryId = m_cmbCategory->currentData().toInt();
     int completedFilter = m_cmbCompleted->currentIndex(); // 0=全部,1=未完成,2=已完成
-    QList<Task> filteredTasks = m_taskManager->getFilteredTasks(priority, categoryId, completedFilter);
 
-    // 导出CSV
-    bool success = m_taskManager->exportTasksToCsv(filePath, filteredTasks);
-    if (success) {
-        QMessageBox::information(this, tr("导出成功"), tr("报表已导出至：\n%1").arg(filePath));
-    } else {
-        QMessageBox::critical(this, tr("导出失败"), tr("无法导出报表，请检查文件路径权限！"));
+    // 启动后台导出（结果在exportFinished信号中提示）
+    if (!m_taskManager->exportFilteredTasksToCsv(filePath, priority, categoryId, completedFilter)) {
+        QMessageBox::warning(this, tr("提示"), tr("已有报表正在导出，请稍后再试！"));
+        return;
+    }
+
+    // 非模态进度框：导出期间可继续编辑任务，点击取消会删除未完成的文件
+    m_exportProgressDialog = new QProgressDialog(tr("正在导出报表..."), tr("取消"), 0, 1000, this);
+    m_exportProgressDialog->setWindowTitle(tr("导出报表"));
+    m_exportProgressDialog->setWindowModality(Qt::NonModal);
+    m_exportProgressDialog->setAutoClose(false);
+    m_exportProgressDialog->setAutoReset(false);
+    m_exportProgressDialog->setMinimumDuration(0);
+    connect(m_exportProgressDialog, &QProgressDialog::canceled, m_taskManager, &TaskManager::cancelExport);
+    m_exportProgressDialog->show();
+}
+
+void MainWindow::onImportCsvClicked()
+{
+    if (m_importWatcher->isRunning()) {
+        QMessageBox::warning(this, tr("提示"), tr("已有任务正在导入，请稍后再试！"));
+        return;
     }
+
+    QString filePath = QFileDialog::getOpenFileName(this, tr("导入CSV任务"),
+                                                    QDir::homePath(), tr("CSV文件 (*.csv)"));
+    if (filePath.isEmpty()) return;
+
+    // 在数据库工作线程上导入（结果在m_importWatcher完成后提示）
+    statusBar()->showMessage(tr("正在导入任务..."));
+    m_importWatcher->setFuture(m_taskManager->importTasksFromCsvAsync(filePath));
 }
 
 void MainWindow::onFilterChanged()
@@ -332,16 +493,23 @@ void MainWindow::onFilterChanged()
     int categoryFilter = m_cmbCategory->currentData().toInt(); // -1=全部
     int completedFilter = m_cmbCompleted->currentIndex(); // 0=全部,1=未完成,2=已完成
 
-    // 按条件筛选（将筛选逻辑统一交给TaskManager处理）
-    QList<Task> filteredTasks = m_taskManager->getFilteredTasks(priorityFilter, categoryFilter, completedFilter);
-    m_taskModel->setTasks(filteredTasks, m_taskManager->getCategories());
+    // 筛选结果取代尚未返回的搜索结果
+    m_searchWatcher->cancel();
+
+    // 按条件分页筛选（将筛选逻辑统一交给TaskManager处理），表格滚动到底部时再加载后续页
+    m_taskModel->setPageFetcher([=](const TaskOrder &order, const Task *after, int limit) {
+        return m_taskManager->getFilteredTasksPage(priorityFilter, categoryFilter, completedFilter, order, after, limit);
+    }, [=](const Task &task) {
+        return TaskManager::matchesFilter(task, priorityFilter, categoryFilter, completedFilter);
+    }, m_taskManager->categoryDictionary());
+    int filteredCount = m_taskManager->countFilteredTasks(priorityFilter, categoryFilter, completedFilter);
 
     // 优化状态提示
     QString statusText;
     if (completedFilter == 0 && priorityFilter == -1 && categoryFilter == -1) {
-        statusText = tr("当前显示所有任务（%1条）").arg(filteredTasks.size());
+        statusText = tr("当前显示所有任务（%1条）").arg(filteredCount);
     } else {
-        statusText = tr("筛选结果：%1 条任务").arg(filteredTasks.size());
+        statusText = tr("筛选结果：%1 条任务").arg(filteredCount);
     }
     statusBar()->showMessage(statusText);
 }
@@ -364,7 +532,7 @@ void MainWindow::onResetFilterClicked()
 void MainWindow::onManageCategoriesClicked()
 {
     // 加载当前分类列表到对话框
-    m_categoryDialog->setCategories(m_taskManager->getCategories());
+    m_categoryDialog->setCategories(m_taskManager->categoryDictionary());
     
     // 显示对话框
     m_categoryDialog->exec();
@@ -385,14 +553,21 @@ void MainWindow::onBackupDatabaseClicked()
         return;
     }
     
-    // 执行备份操作
-    bool success = m_taskManager->backupDatabase(backupPath);
-    
-    if (success) {
-        QMessageBox::information(this, tr("成功"), tr("数据库备份成功！\n备份路径：%1").arg(backupPath));
-    } else {
-        QMessageBox::critical(this, tr("失败"), tr("数据库备份失败，请检查路径权限或数据库连接！"));
+    // 启动后台备份（结果在backupFinished信号中提示）
+    if (!m_taskManager->backupDatabase(backupPath)) {
+        QMessageBox::warning(this, tr("提示"), tr("已有数据库备份正在进行，请稍后再试！"));
+        return;
     }
+
+    // 非模态进度框：备份期间可继续编辑任务，点击取消时已有的备份文件保持不变
+    m_backupProgressDialog = new QProgressDialog(tr("正在备份数据库..."), tr("取消"), 0, 1000, this);
+    m_backupProgressDialog->setWindowTitle(tr("备份数据"));
+    m_backupProgressDialog->setWindowModality(Qt::NonModal);
+    m_backupProgressDialog->setAutoClose(false);
+    m_backupProgressDialog->setAutoReset(false);
+    m_backupProgressDialog->setMinimumDuration(0);
+    connect(m_backupProgressDialog, &QProgressDialog::canceled, m_taskManager, &TaskManager::cancelBackup);
+    m_backupProgressDialog->show();
 }
 
 void MainWindow::onRestoreDatabaseClicked()
@@ -434,8 +609,22 @@ void MainWindow::onRestoreDatabaseClicked()
     }
 }
 
+void MainWindow::onSearchTextEdited(const QString &text)
+{
+    if (text.trimmed().isEmpty()) {
+        // 清空关键字立即恢复筛选列表
+        m_searchDebounceTimer->stop();
+        onFilterChanged();
+        return;
+    }
+    m_searchDebounceTimer->start();
+}
+
 void MainWindow::onSearchClicked()
 {
+    // 按钮、回车或防抖定时器触发，立即搜索
+    m_searchDebounceTimer->stop();
+
     // 获取搜索关键字
     QString keyword = m_leSearch->text().trimmed();
     
@@ -445,12 +634,8 @@ void MainWindow::onSearchClicked()
         return;
     }
     
-    // 执行搜索
-    QList<Task> searchResults = m_taskManager->searchTasks(keyword);
-    
-    // 更新任务列表
-    m_taskModel->setTasks(searchResults, m_taskManager->getCategories());
-    
-    // 更新状态栏信息
-    statusBar()->showMessage(QString(tr("搜索结果：找到 %1 条匹配任务")).arg(searchResults.size()), 3000);
+    // 在数据库工作线程执行搜索（结果按相关度排序，并附带命中位置的高亮摘要），继续输入时在上一次结果中细化；
+    // 新的搜索会取代尚未返回的旧搜索，结果在m_searchWatcher完成时更新任务列表
+    m_searchWatcher->setFuture(m_taskManager->searchTasksAsync(keyword));
+    statusBar()->showMessage(tr("正在搜索..."));
 }
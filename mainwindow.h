@@ -14,6 +14,10 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QSystemTrayIcon>
+#include <QProgressDialog>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
+#include <QTimer>
 #include "taskmanager.h"
 #include "taskmodel.h"
 #include "addtaskdialog.h"
@@ -29,6 +33,12 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override;
 
+    // 启动耗时统计：startupTimer在进程入口开始计时，任务列表首次绘制完成后输出耗时
+    void measureStartup(const QElapsedTimer &startupTimer);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
     // 工具栏按钮槽函数
     void onAddTaskClicked();    // 添加任务
@@ -36,10 +46,12 @@ private slots:
     void onDeleteTaskClicked(); // 删除任务
     void onMarkCompletedClicked(); // 标记完成
     void onExportCsvClicked();  // 导出CSV
+    void onImportCsvClicked();  // 导入CSV
     // 筛选区槽函数
     void onFilterChanged();     // 筛选条件变化
     void onResetFilterClicked();// 重置筛选
     void onSearchClicked();     // 搜索任务
+    void onSearchTextEdited(const QString &text); // 输入搜索关键字（防抖后自动搜索）
     // 分类管理槽函数
     void onManageCategoriesClicked(); // 打开分类管理对话框
     // 数据库管理槽函数
@@ -64,6 +76,16 @@ private:
     AddTaskDialog *m_addTaskDialog; // 添加/编辑任务对话框
     CategoryDialog *m_categoryDialog; // 分类管理对话框
 
+    // 异步操作结果监视（结果在GUI线程的事件循环中处理）
+    QFutureWatcher<TaskSearchResult> *m_searchWatcher;   // 搜索
+    QFutureWatcher<TaskStatistics> *m_statisticsWatcher; // 完成率统计
+    QFutureWatcher<CsvImportResult> *m_importWatcher;    // CSV导入
+    QProgressDialog *m_exportProgressDialog = nullptr;   // 报表导出进度（非模态，导出期间可继续编辑）
+    QProgressDialog *m_backupProgressDialog = nullptr;   // 数据库备份进度（非模态，可取消）
+    QElapsedTimer m_startupTimer;                        // 启动计时（任务列表首次绘制后失效）
+    static constexpr int kSearchDebounceMs = 200;        // 停止输入多久后开始搜索
+    QTimer *m_searchDebounceTimer;                       // 边输入边搜索的防抖定时器
+
     // UI控件
     QToolBar *m_toolBar;                // 工具栏
     QWidget *m_filterWidget;            // 筛选区容器
@@ -1,39 +1,114 @@
 #include "reminderthread.h"
-#include "sqlrepository.h"
+#include "logging.h"
+#include <QDateTime>
+#include <QDeadlineTimer>
 
 ReminderThread::ReminderThread(QObject *parent)
     : QThread(parent)
-    , m_repo(SqlRepository::getInstance()) // 唯一合法的获取方式
 {
-    m_isRunning = false;
+    m_stopRequested = false;
     m_reminderMinutes = 30; // 默认提前30分钟提醒
-    m_timer = nullptr; // 不再使用定时器，设置为nullptr
 }
 
 ReminderThread::~ReminderThread()
 {
     stop();
-    // 不再使用定时器，无需deleteLater
 }
 
 void ReminderThread::stop()
 {
-    m_isRunning = false;
+    QMutexLocker locker(&m_mutex);
+    m_stopRequested = true;
     requestInterruption(); // 请求线程中断
+    m_wakeUp.wakeAll();
+}
+
+void ReminderThread::setTasks(const QList<Task> &tasks)
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue = decltype(m_queue)();
+    m_pending.clear();
+    // 整体替换（导入、恢复、后台重新加载）时保留仍以相同截止时间存在的任务的已提醒记录，
+    // 与scheduleLocked一致，避免对同一截止时间重复弹出提醒；不在新列表中的记录丢弃
+    QHash<int, qint64> notified;
+    notified.swap(m_notified);
+    for (const Task &task : tasks) {
+        qint64 deadline = task.deadline.toSecsSinceEpoch();
+        if (notified.value(task.taskId, -1) == deadline) {
+            m_notified.insert(task.taskId, deadline);
+        }
+        scheduleLocked(task);
+    }
+    m_wakeUp.wakeAll();
+}
+
+void ReminderThread::scheduleTask(const Task &task)
+{
+    QMutexLocker locker(&m_mutex);
+    scheduleLocked(task);
+    m_wakeUp.wakeAll();
+}
+
+void ReminderThread::unscheduleTask(int taskId)
+{
+    // 堆中的条目在弹出时因找不到任务而被丢弃，无需唤醒线程
+    QMutexLocker locker(&m_mutex);
+    m_pending.remove(taskId);
+    m_notified.remove(taskId);
+}
+
+void ReminderThread::scheduleLocked(const Task &task)
+{
+    qint64 deadline = task.deadline.toSecsSinceEpoch();
+    if (task.isCompleted || deadline <= QDateTime::currentSecsSinceEpoch()) {
+        m_pending.remove(task.taskId);
+        return;
+    }
+    if (m_notified.value(task.taskId, -1) == deadline) {
+        return; // 本次截止时间已提醒过
+    }
+    m_notified.remove(task.taskId);
+
+    m_pending.insert(task.taskId, task);
+    m_queue.push({deadline * 1000 - qint64(m_reminderMinutes) * 60 * 1000, task.taskId, deadline});
 }
 
 void ReminderThread::run()
 {
-    while (!isInterruptionRequested()) {
-        // ✅ 通过单例引用调用接口
-        QList<Task> reminderTasks = m_repo.getPendingTasksWithReminder(m_reminderMinutes);
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopRequested) {
+        // 取出所有已到提醒时刻的任务
+        qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+        QList<Task> reminderTasks;
+        while (!m_queue.empty() && m_queue.top().remindAtMs <= nowMs) {
+            Entry entry = m_queue.top();
+            m_queue.pop();
+            auto it = m_pending.find(entry.taskId);
+            if (it == m_pending.end() || it->deadline.toSecsSinceEpoch() != entry.deadline) {
+                continue; // 任务已删除、完成或截止时间已修改
+            }
+            // 截止时间已过（如系统休眠期间错过）不再提醒
+            if (entry.deadline * 1000 > nowMs) {
+                reminderTasks.append(it.value());
+            }
+            m_notified.insert(entry.taskId, entry.deadline);
+            m_pending.erase(it);
+        }
+
         if (!reminderTasks.isEmpty()) {
-            // 发送提醒信号（任务列表）
+            // 发送信号时不持有锁，避免与调度接口互相等待
+            locker.unlock();
             emit taskReminder(reminderTasks); // 发送任务列表
-            qDebug() << "提醒线程：发现" << reminderTasks.size() << "个需提醒任务";
+            qCDebug(lcReminder) << "提醒线程：发现" << reminderTasks.size() << "个需提醒任务";
+            locker.relock();
+            continue;
+        }
+
+        // 休眠到下一个提醒时刻；调度变化或停止时被提前唤醒
+        if (m_queue.empty()) {
+            m_wakeUp.wait(&m_mutex);
+        } else {
+            m_wakeUp.wait(&m_mutex, QDeadlineTimer(m_queue.top().remindAtMs - nowMs));
         }
-        msleep(60000); // 每分钟检查一次提醒任务
     }
 }
-
-
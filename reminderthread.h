@@ -2,10 +2,16 @@
 #define REMINDERTHREAD_H
 
 #include <QThread>
-#include <QTimer>
 #include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <queue>
+#include <vector>
 #include "sqlrepository.h"
 
+// 提醒调度线程：按提醒时刻（截止时间减提前量）维护最小堆，精确休眠到下一个提醒时刻，
+// 任务增删改时由TaskManager通知并立即唤醒重新计算，停止时立即返回
 class ReminderThread : public QThread
 {
     Q_OBJECT
@@ -13,7 +19,12 @@ public:
     explicit ReminderThread(QObject *parent = nullptr);
     ~ReminderThread();
 
-    void stop(); // 停止线程
+    void stop(); // 停止线程（立即唤醒并退出）
+
+    // 调度接口（可在任意线程调用）
+    void setTasks(const QList<Task> &tasks); // 替换全部待提醒任务（截止时间未变的任务不重复提醒）
+    void scheduleTask(const Task &task);     // 新增或更新任务的提醒（已完成或已过期的任务会被取消）
+    void unscheduleTask(int taskId);         // 取消任务的提醒
 
 signals:
     // 发送需提醒的任务列表
@@ -23,10 +34,23 @@ protected:
     void run() override; // 线程执行入口
 
 private:
-    SqlRepository &m_repo;
-    QTimer *m_timer;      // 定时触发器（已废弃）
-    bool m_isRunning;     // 线程运行标志
-    int m_reminderMinutes; // 提醒提前时间（默认30分钟）
+    // 堆中的提醒条目；任务修改后旧条目不删除，弹出时与m_pending比对后丢弃
+    struct Entry {
+        qint64 remindAtMs; // 提醒时刻（UTC毫秒时间戳）
+        int taskId;
+        qint64 deadline;   // 入堆时任务的截止时间，用于识别过期条目
+        bool operator>(const Entry &other) const { return remindAtMs > other.remindAtMs; }
+    };
+
+    void scheduleLocked(const Task &task); // 调用方需持有m_mutex
+
+    QMutex m_mutex;
+    QWaitCondition m_wakeUp; // 调度变化或停止时唤醒线程
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> m_queue; // 按提醒时刻排序的最小堆
+    QHash<int, Task> m_pending; // 尚未提醒的任务：任务ID -> 任务
+    QHash<int, qint64> m_notified; // 已提醒的任务ID -> 提醒时的截止时间（截止时间不变的修改不重复提醒）
+    bool m_stopRequested;       // 线程停止标志（受m_mutex保护）
+    int m_reminderMinutes;      // 提醒提前时间（默认30分钟）
 };
 
 #endif // REMINDERTHREAD_H
@@ -1,259 +1,693 @@
 #include "sqlrepository.h"
+#include "logging.h"
 #include "QFile"
 #include "QFileInfo"
 #include "qdir.h"
 #include <QCoreApplication>
+#include <QThread>
+#include <QSqlDriver>
+#include <QMutexLocker>
+#include <sqlite3.h>
 
-SqlRepository::SqlRepository(QObject *parent) : QObject(parent)
+SqlRepository::SqlRepository(QObject *parent)
+    // 数据库路径 - 使用构建目录下的数据库文件（确保有写入权限）
+    : SqlRepository(QCoreApplication::applicationDirPath() + "/TaskManager.db", parent)
+{
+}
+
+SqlRepository::SqlRepository(const QString &databasePath, QObject *parent) : QObject(parent)
 {
-    qDebug() << "开始初始化SqlRepository";
-    initDatabase();
+    qCDebug(lcSql) << "开始初始化SqlRepository";
+    initDatabase(databasePath);
+    QSqlDatabase database = connection();
     if (database.isOpen()) {
-        qDebug() << "数据库已打开，开始初始化表";
+        qCDebug(lcSql) << "数据库已打开，开始初始化表";
         if (initTables()) {
-            qDebug() << "表初始化成功";
+            qCDebug(lcSql) << "表初始化成功";
             emit statusUpdated("数据库连接成功");
-            qDebug() << "数据库连接成功";
+            qCDebug(lcSql) << "数据库连接成功";
         } else {
-            qCritical() << "数据库表初始化失败";
+            qCCritical(lcSql) << "数据库表初始化失败";
             emit statusUpdated("数据库表初始化失败");
         }
     } else {
         QString error = "数据库连接失败：" + database.lastError().text();
         emit statusUpdated(error);
-        qCritical() << error;
+        qCCritical(lcSql) << error;
     }
-    qDebug() << "SqlRepository初始化完成";
+    qCDebug(lcSql) << "SqlRepository初始化完成";
 }
 
 SqlRepository::~SqlRepository()
 {
-    // 析构函数中关闭数据库连接
-    if (database.isOpen()) {
-        database.close();
-        qDebug() << "数据库连接已关闭，所有更改已保存";
+    // 析构函数中关闭当前线程（主线程）的数据库连接，其他线程的连接随线程退出释放
+    if (m_connections.hasLocalData()) {
+        m_connections.setLocalData(nullptr);
+        qCDebug(lcSql) << "数据库连接已关闭，所有更改已保存";
     }
-    qDebug() << "SqlRepository析构函数被调用";
+    qCDebug(lcSql) << "SqlRepository析构函数被调用";
 }
 
-void SqlRepository::initDatabase()
+void SqlRepository::initDatabase(const QString &databasePath)
 {
-    // 检查SQLite驱动是否可用
-    qDebug() << "=== SQLite数据库初始化开始 ===";
-    qDebug() << "SQLite驱动是否可用：" << QSqlDatabase::isDriverAvailable("QSQLITE");
-    
-    // 获取可用的数据库驱动列表
-    qDebug() << "可用的数据库驱动：" << QSqlDatabase::drivers();
-
-    // 使用独立连接名避免冲突（与idatabase保持风格且不冲突）
-    database = QSqlDatabase::addDatabase("QSQLITE", "SqlRepoConnection");
-    qDebug() << "数据库连接名称：" << database.connectionName();
-    // 数据库路径 - 使用构建目录下的数据库文件（确保有写入权限）
-    QString dbPath = QCoreApplication::applicationDirPath() + "/TaskManager.db";
-    database.setDatabaseName(dbPath);
-
-    // 路径验证信息（保持原调试输出风格）
-    qDebug() << "=== 数据库路径验证 ===";
-    qDebug() << "配置的路径：" << dbPath;
-    qDebug() << "路径是否存在：" << QFile::exists(dbPath);
-    qDebug() << "所在目录是否存在：" << QDir(QFileInfo(dbPath).dir().path()).exists();
-    
-    // 检查文件权限
-    QFile dbFile(dbPath);
-    qDebug() << "文件是否可读：" << dbFile.isReadable();
-    qDebug() << "文件是否可写：" << dbFile.isWritable();
+    // 使用独立连接名避免冲突（与idatabase保持风格且不冲突），作为创建实例的线程（主线程）的连接
+    ThreadConnection *mainConnection = new ThreadConnection;
+    mainConnection->database = QSqlDatabase::addDatabase("QSQLITE", nextConnectionName());
+    m_connections.setLocalData(mainConnection);
+    QSqlDatabase &database = mainConnection->database;
+    qCDebug(lcSql) << "数据库连接名称：" << database.connectionName();
+    m_databasePath = databasePath;
+    database.setDatabaseName(databasePath);
 
     // 尝试打开数据库
-    if (!database.open()) {
-        qCritical() << "数据库打开失败：" << database.lastError().text();
+    if (!openConnection(database)) {
+        qCCritical(lcSql) << "数据库打开失败：" << database.lastError().text();
         return;
     }
-    qDebug() << "数据库打开成功！";
-    
-    // 获取数据库连接信息
-    qDebug() << "数据库名称：" << database.databaseName();
-    qDebug() << "数据库驱动：" << database.driverName();
-    qDebug() << "数据库是否打开：" << database.isOpen();
-    
-    // 查询SQLite版本
-    QSqlQuery versionQuery(database);
-    versionQuery.exec("SELECT sqlite_version()");
-    if (versionQuery.next()) {
-        qDebug() << "SQLite版本：" << versionQuery.value(0).toString();
+    qCDebug(lcSql) << "数据库打开成功：" << databasePath;
+
+    // 诊断查询会拖慢启动，默认不执行
+    if (lcSqlDiagnostics().isDebugEnabled()) {
+        logDiagnostics(database);
     }
-    
-    // 检查是否存在category表
-    QSqlQuery tableQuery(database);
-    tableQuery.exec("SELECT name FROM sqlite_master WHERE type='table' AND name='category'");
-    qDebug() << "category表是否存在：" << tableQuery.next();
-    
-    // 检查是否存在task表
-    tableQuery.exec("SELECT name FROM sqlite_master WHERE type='table' AND name='task'");
-    qDebug() << "task表是否存在：" << tableQuery.next();
+}
 
-    // 初始化时查询任务和分类数量（保持原逻辑）
-    QSqlQuery countQuery(database);
+void SqlRepository::logDiagnostics(QSqlDatabase &database)
+{
+    qCDebug(lcSqlDiagnostics) << "=== 数据库诊断信息 ===";
+    qCDebug(lcSqlDiagnostics) << "SQLite驱动是否可用：" << QSqlDatabase::isDriverAvailable("QSQLITE");
+    qCDebug(lcSqlDiagnostics) << "可用的数据库驱动：" << QSqlDatabase::drivers();
 
-    // 查询未完成任务数
-    countQuery.exec("SELECT COUNT(*) FROM task WHERE is_completed=0");
-    if (countQuery.next()) {
-        qDebug() << "当前db中未完成任务数：" << countQuery.value(0).toInt();
-    } else {
-        qDebug() << "查询未完成任务数失败：" << countQuery.lastError().text();
+    // 路径与文件权限
+    QString dbPath = database.databaseName();
+    QFile dbFile(dbPath);
+    qCDebug(lcSqlDiagnostics) << "配置的路径：" << dbPath;
+    qCDebug(lcSqlDiagnostics) << "所在目录是否存在：" << QDir(QFileInfo(dbPath).dir().path()).exists();
+    qCDebug(lcSqlDiagnostics) << "文件是否可读：" << dbFile.isReadable();
+    qCDebug(lcSqlDiagnostics) << "文件是否可写：" << dbFile.isWritable();
+    qCDebug(lcSqlDiagnostics) << "数据库驱动：" << database.driverName();
+
+    // 诊断查询只执行一次，不进入预编译语句缓存
+    QSqlQuery query(database);
+    if (query.exec("SELECT sqlite_version()") && query.next()) {
+        qCDebug(lcSqlDiagnostics) << "SQLite版本：" << query.value(0).toString();
+    }
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        qCDebug(lcSqlDiagnostics) << "数据库结构版本：" << query.value(0).toInt();
+    }
+    if (query.exec("SELECT COUNT(*) FROM task WHERE is_completed=0") && query.next()) {
+        qCDebug(lcSqlDiagnostics) << "当前db中未完成任务数：" << query.value(0).toInt();
+    }
+    if (query.exec("SELECT category_id, category_name FROM category ORDER BY category_id")) {
+        qCDebug(lcSqlDiagnostics) << "所有分类数据：";
+        while (query.next()) {
+            qCDebug(lcSqlDiagnostics) << "分类ID：" << query.value(0).toInt() << "，名称：" << query.value(1).toString();
+        }
+    }
+    if (query.exec("SELECT task_id, title, is_completed FROM task LIMIT 10")) {
+        qCDebug(lcSqlDiagnostics) << "前10个任务数据：";
+        while (query.next()) {
+            qCDebug(lcSqlDiagnostics) << "任务ID：" << query.value(0).toInt() << "，标题：" << query.value(1).toString() << "，完成状态：" << query.value(2).toInt();
+        }
     }
+    query.finish();
+    qCDebug(lcSqlDiagnostics) << "=== 数据库诊断结束 ===";
+}
 
-    // 查询分类数
-    countQuery.exec("SELECT COUNT(*) FROM category");
-    if (countQuery.next()) {
-        qDebug() << "当前db中分类数：" << countQuery.value(0).toInt();
-    } else {
-        qDebug() << "查询分类数失败：" << countQuery.lastError().text();
+bool SqlRepository::initTables()
+{
+    // 只读取一次user_version：已是最新版本时直接返回，不再逐项检查表和分类
+    int version = schemaVersion();
+    if (version < 0) {
+        return false;
     }
 
-    // 查询所有分类数据
-    countQuery.exec("SELECT category_id, category_name FROM category ORDER BY category_id");
-    qDebug() << "所有分类数据：";
-    while (countQuery.next()) {
-        qDebug() << "分类ID：" << countQuery.value(0).toInt() << "，名称：" << countQuery.value(1).toString();
+    // 按版本号依次执行结构迁移（建表、建索引等），旧库会在此原地升级
+    if (!migrateSchema(version)) {
+        qCCritical(lcSql) << "数据库结构迁移失败";
+        return false;
     }
 
-    // 查询所有任务数据
-    countQuery.exec("SELECT task_id, title, is_completed FROM task LIMIT 10");
-    qDebug() << "前10个任务数据：";
-    while (countQuery.next()) {
-        qDebug() << "任务ID：" << countQuery.value(0).toInt() << "，标题：" << countQuery.value(1).toString() << "，完成状态：" << countQuery.value(2).toInt();
+    // 默认分类只在新建数据库时写入，用户之后删除的分类不会被重新添加
+    if (version == 0 && !seedDefaultCategories()) {
+        qCCritical(lcSql) << "写入默认分类失败";
+        return false;
     }
-    qDebug() << "=== 数据库初始化完成 ===";
+    return true;
 }
 
-bool SqlRepository::initTables()
+bool SqlRepository::seedDefaultCategories()
 {
-    // 创建分类表
-    QString createCategoryTable = "CREATE TABLE IF NOT EXISTS category (category_id INTEGER PRIMARY KEY AUTOINCREMENT, category_name TEXT NOT NULL UNIQUE)";
-    qDebug() << "创建分类表SQL:" << createCategoryTable;
-    if (!executeSql(createCategoryTable)) {
-        qCritical() << "创建分类表失败";
-        return false;
+    // 单个事务批量写入；旧版本未记录user_version的数据库可能已有这些分类，重复的直接忽略
+    const QStringList defaultCategories = {"工作", "学习", "生活", "娱乐"};
+    QList<QVariantList> rows;
+    for (const QString &categoryName : defaultCategories) {
+        rows.append(QVariantList{categoryName});
     }
-    qDebug() << "分类表创建成功";
+    return executeBatch("INSERT OR IGNORE INTO category (category_name) VALUES (?)", rows);
+}
+
+namespace {
+
+// 数据库结构迁移步骤：version即迁移完成后写入PRAGMA user_version的值
+// 注意：已发布的迁移不能修改，只能在末尾追加新版本
+struct SchemaMigration {
+    int version;
+    QString description;
+    QStringList statements;
+    // 依赖FTS5 trigram分词的语句：SQLite未编译FTS5或版本过旧（trigram需3.34+）时跳过，搜索退回LIKE扫描
+    QStringList fullTextStatements = {};
+};
 
-    // 创建任务表
-    QString createTaskTable = "CREATE TABLE IF NOT EXISTS task (task_id INTEGER PRIMARY KEY AUTOINCREMENT, title TEXT NOT NULL, description TEXT, deadline DATETIME NOT NULL, priority INTEGER DEFAULT 2, is_completed INTEGER DEFAULT 0, category_id INTEGER DEFAULT 1, FOREIGN KEY (category_id) REFERENCES category (category_id))";
-    qDebug() << "创建任务表SQL:" << createTaskTable;
-    if (!executeSql(createTaskTable)) {
-        qCritical() << "创建任务表失败";
+// 试建一张临时trigram全文表探测支持情况，在保存点内执行并回滚，不留下任何结构
+bool supportsFullTextTrigram(const QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if (!query.exec("SAVEPOINT fts_probe")) {
         return false;
     }
-    qDebug() << "任务表创建成功";
+    bool supported = query.exec("CREATE VIRTUAL TABLE temp.fts_probe USING fts5(text, tokenize='trigram')");
+    query.exec("ROLLBACK TO fts_probe");
+    query.exec("RELEASE fts_probe");
+    return supported;
+}
 
-    // 初始化默认分类
+bool hasFullTextTable(const QSqlDatabase &database)
+{
     QSqlQuery query(database);
-    
-    // 先检查所有必要的分类
-    QStringList requiredCategories = {"工作", "学习", "生活", "娱乐"};
-    
-    for (const QString &categoryName : requiredCategories) {
-        // 检查分类是否存在
-        query.exec(QString("SELECT COUNT(*) FROM category WHERE category_name = '%1'")
-                  .arg(categoryName));
-        
-        if (query.next() && query.value(0).toInt() == 0) {
-            // 分类不存在，添加
-            if (addCategory(categoryName)) {
-                qDebug() << "添加分类成功：" << categoryName;
-            } else {
-                qCritical() << "添加分类失败：" << categoryName;
+    return query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'task_fts'") && query.next();
+}
+
+const QList<SchemaMigration> &schemaMigrations()
+{
+    static const QList<SchemaMigration> migrations = {
+        {1, "创建分类表和任务表", {
+             "CREATE TABLE IF NOT EXISTS category (category_id INTEGER PRIMARY KEY AUTOINCREMENT, category_name TEXT NOT NULL UNIQUE)",
+             "CREATE TABLE IF NOT EXISTS task (task_id INTEGER PRIMARY KEY AUTOINCREMENT, title TEXT NOT NULL, description TEXT, deadline DATETIME NOT NULL, priority INTEGER DEFAULT 2, is_completed INTEGER DEFAULT 0, category_id INTEGER DEFAULT 1, FOREIGN KEY (category_id) REFERENCES category (category_id))"
+         }},
+        {2, "为筛选和提醒查询添加复合索引", {
+             // 无筛选条件时按截止时间排序
+             "CREATE INDEX IF NOT EXISTS idx_task_deadline ON task (deadline)",
+             // 完成状态筛选 + 提醒查询（is_completed=0 AND deadline BETWEEN ...）
+             "CREATE INDEX IF NOT EXISTS idx_task_completed_deadline ON task (is_completed, deadline)",
+             // 分类筛选（可叠加完成状态），同时覆盖isCategoryUsed()
+             "CREATE INDEX IF NOT EXISTS idx_task_category_completed_deadline ON task (category_id, is_completed, deadline)",
+             // 优先级筛选（可叠加完成状态）
+             "CREATE INDEX IF NOT EXISTS idx_task_priority_completed_deadline ON task (priority, is_completed, deadline)"
+         }},
+        {3, "创建任务全文索引（FTS5 trigram分词，支持中文子串搜索）", {}, {
+             // 外部内容表：只存倒排索引，正文仍在task表中，rowid即task_id
+             "CREATE VIRTUAL TABLE IF NOT EXISTS task_fts USING fts5(title, description, content='task', content_rowid='task_id', tokenize='trigram')",
+             // 通过触发器与task表保持同步
+             "CREATE TRIGGER IF NOT EXISTS task_fts_ai AFTER INSERT ON task BEGIN "
+             "INSERT INTO task_fts(rowid, title, description) VALUES (new.task_id, new.title, new.description); END",
+             "CREATE TRIGGER IF NOT EXISTS task_fts_ad AFTER DELETE ON task BEGIN "
+             "INSERT INTO task_fts(task_fts, rowid, title, description) VALUES ('delete', old.task_id, old.title, old.description); END",
+             "CREATE TRIGGER IF NOT EXISTS task_fts_au AFTER UPDATE OF title, description ON task BEGIN "
+             "INSERT INTO task_fts(task_fts, rowid, title, description) VALUES ('delete', old.task_id, old.title, old.description); "
+             "INSERT INTO task_fts(rowid, title, description) VALUES (new.task_id, new.title, new.description); END",
+             // 为已有任务建立索引
+             "INSERT INTO task_fts(task_fts) VALUES ('rebuild')"
+         }},
+        {4, "截止时间改为INTEGER秒级时间戳（UTC）", {
+             // SQLite不支持修改列类型，按新结构重建task表
+             "CREATE TABLE task_new (task_id INTEGER PRIMARY KEY AUTOINCREMENT, title TEXT NOT NULL, description TEXT, deadline INTEGER NOT NULL, priority INTEGER DEFAULT 2, is_completed INTEGER DEFAULT 0, category_id INTEGER DEFAULT 1, FOREIGN KEY (category_id) REFERENCES category (category_id))",
+             // 旧数据为本地时间文本（yyyy-MM-dd HH:mm[:ss]），'utc'修饰符将其从本地时间换算为UTC时间戳；无法解析的记为0
+             "INSERT INTO task_new (task_id, title, description, deadline, priority, is_completed, category_id) "
+             "SELECT task_id, title, description, "
+             "CASE WHEN typeof(deadline) = 'integer' THEN deadline ELSE COALESCE(CAST(strftime('%s', deadline, 'utc') AS INTEGER), 0) END, "
+             "priority, is_completed, category_id FROM task",
+             // DROP TABLE会删除task在sqlite_sequence中的记录，task_new只记到现存的最大ID；
+             // 沿用旧表的自增序号，已删除任务的ID不会被重新分配（重命名时序号记录随表改名）
+             "DELETE FROM sqlite_sequence WHERE name = 'task_new'",
+             "INSERT INTO sqlite_sequence (name, seq) SELECT 'task_new', seq FROM sqlite_sequence WHERE name = 'task'",
+             "DROP TABLE task",
+             "ALTER TABLE task_new RENAME TO task",
+             // 重建表后索引和触发器需重新创建（task_id保持不变，全文索引内容无需重建）
+             "CREATE INDEX idx_task_deadline ON task (deadline)",
+             "CREATE INDEX idx_task_completed_deadline ON task (is_completed, deadline)",
+             "CREATE INDEX idx_task_category_completed_deadline ON task (category_id, is_completed, deadline)",
+             "CREATE INDEX idx_task_priority_completed_deadline ON task (priority, is_completed, deadline)"
+         }, {
+             "CREATE TRIGGER task_fts_ai AFTER INSERT ON task BEGIN "
+             "INSERT INTO task_fts(rowid, title, description) VALUES (new.task_id, new.title, new.description); END",
+             "CREATE TRIGGER task_fts_ad AFTER DELETE ON task BEGIN "
+             "INSERT INTO task_fts(task_fts, rowid, title, description) VALUES ('delete', old.task_id, old.title, old.description); END",
+             "CREATE TRIGGER task_fts_au AFTER UPDATE OF title, description ON task BEGIN "
+             "INSERT INTO task_fts(task_fts, rowid, title, description) VALUES ('delete', old.task_id, old.title, old.description); "
+             "INSERT INTO task_fts(rowid, title, description) VALUES (new.task_id, new.title, new.description); END"
+         }},
+        {5, "创建按分类和优先级汇总的任务计数表（触发器增量维护）", {
+             "CREATE TABLE IF NOT EXISTS task_stats (category_id INTEGER, priority INTEGER, total INTEGER NOT NULL DEFAULT 0, completed INTEGER NOT NULL DEFAULT 0, PRIMARY KEY (category_id, priority))",
+             "INSERT INTO task_stats (category_id, priority, total, completed) "
+             "SELECT category_id, priority, COUNT(*), SUM(is_completed = 1) FROM task GROUP BY category_id, priority",
+             // 每次增删改只调整受影响的一行计数
+             "CREATE TRIGGER IF NOT EXISTS task_stats_ai AFTER INSERT ON task BEGIN "
+             "INSERT INTO task_stats (category_id, priority, total, completed) VALUES (new.category_id, new.priority, 1, new.is_completed = 1) "
+             "ON CONFLICT (category_id, priority) DO UPDATE SET total = total + 1, completed = completed + excluded.completed; END",
+             "CREATE TRIGGER IF NOT EXISTS task_stats_ad AFTER DELETE ON task BEGIN "
+             "UPDATE task_stats SET total = total - 1, completed = completed - (old.is_completed = 1) "
+             "WHERE category_id = old.category_id AND priority = old.priority; END",
+             "CREATE TRIGGER IF NOT EXISTS task_stats_au AFTER UPDATE OF category_id, priority, is_completed ON task BEGIN "
+             "UPDATE task_stats SET total = total - 1, completed = completed - (old.is_completed = 1) "
+             "WHERE category_id = old.category_id AND priority = old.priority; "
+             "INSERT INTO task_stats (category_id, priority, total, completed) VALUES (new.category_id, new.priority, 1, new.is_completed = 1) "
+             "ON CONFLICT (category_id, priority) DO UPDATE SET total = total + 1, completed = completed + excluded.completed; END"
+         }},
+        {6, "添加任务数据版本号（任务增删改时由触发器递增，用于校验任务快照文件）", {
+             "CREATE TABLE IF NOT EXISTS task_generation (id INTEGER PRIMARY KEY CHECK (id = 1), generation INTEGER NOT NULL)",
+             "INSERT OR IGNORE INTO task_generation (id, generation) VALUES (1, 0)",
+             "CREATE TRIGGER IF NOT EXISTS task_generation_ai AFTER INSERT ON task BEGIN "
+             "UPDATE task_generation SET generation = generation + 1 WHERE id = 1; END",
+             "CREATE TRIGGER IF NOT EXISTS task_generation_ad AFTER DELETE ON task BEGIN "
+             "UPDATE task_generation SET generation = generation + 1 WHERE id = 1; END",
+             "CREATE TRIGGER IF NOT EXISTS task_generation_au AFTER UPDATE ON task BEGIN "
+             "UPDATE task_generation SET generation = generation + 1 WHERE id = 1; END"
+         }},
+        {7, "任务计数表的分类和优先级改为非空（空值记为-1），修正空值任务的计数", {
+             // v5中category_id/priority可为NULL：NULL不触发主键冲突（每次插入新增一行），
+             // 触发器中的=比较也匹配不到NULL行，空值任务的计数只增不减；按新结构重建并重新汇总
+             "DROP TRIGGER IF EXISTS task_stats_ai",
+             "DROP TRIGGER IF EXISTS task_stats_ad",
+             "DROP TRIGGER IF EXISTS task_stats_au",
+             "DROP TABLE IF EXISTS task_stats",
+             "CREATE TABLE task_stats (category_id INTEGER NOT NULL, priority INTEGER NOT NULL, total INTEGER NOT NULL DEFAULT 0, completed INTEGER NOT NULL DEFAULT 0, PRIMARY KEY (category_id, priority))",
+             "INSERT INTO task_stats (category_id, priority, total, completed) "
+             "SELECT IFNULL(category_id, -1), IFNULL(priority, -1), COUNT(*), SUM(is_completed IS 1) FROM task "
+             "GROUP BY IFNULL(category_id, -1), IFNULL(priority, -1)",
+             "CREATE TRIGGER task_stats_ai AFTER INSERT ON task BEGIN "
+             "INSERT INTO task_stats (category_id, priority, total, completed) "
+             "VALUES (IFNULL(new.category_id, -1), IFNULL(new.priority, -1), 1, new.is_completed IS 1) "
+             "ON CONFLICT (category_id, priority) DO UPDATE SET total = total + 1, completed = completed + excluded.completed; END",
+             "CREATE TRIGGER task_stats_ad AFTER DELETE ON task BEGIN "
+             "UPDATE task_stats SET total = total - 1, completed = completed - (old.is_completed IS 1) "
+             "WHERE category_id = IFNULL(old.category_id, -1) AND priority = IFNULL(old.priority, -1); END",
+             "CREATE TRIGGER task_stats_au AFTER UPDATE OF category_id, priority, is_completed ON task BEGIN "
+             "UPDATE task_stats SET total = total - 1, completed = completed - (old.is_completed IS 1) "
+             "WHERE category_id = IFNULL(old.category_id, -1) AND priority = IFNULL(old.priority, -1); "
+             "INSERT INTO task_stats (category_id, priority, total, completed) "
+             "VALUES (IFNULL(new.category_id, -1), IFNULL(new.priority, -1), 1, new.is_completed IS 1) "
+             "ON CONFLICT (category_id, priority) DO UPDATE SET total = total + 1, completed = completed + excluded.completed; END"
+         }},
+        {8, "添加随机的数据库标识（与任务数据版本号一起校验任务快照文件）", {
+             // v6的版本号从0开始，另一个数据库文件的版本号可能恰好相同，只比较版本号会误用其他数据库的快照
+             "ALTER TABLE task_generation ADD COLUMN database_id INTEGER NOT NULL DEFAULT 0",
+             "UPDATE task_generation SET database_id = random() WHERE id = 1"
+         }},
+    };
+    return migrations;
+}
+
+} // namespace
+
+int SqlRepository::schemaVersion()
+{
+    QSqlQuery query(connection());
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qCCritical(lcSql) << "读取数据库版本失败：" << query.lastError().text();
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+DataVersion SqlRepository::dataVersion()
+{
+    DataVersion version;
+    QSqlQuery *query = preparedQuery("SELECT database_id, generation FROM task_generation WHERE id = 1");
+    if (!query) {
+        return version;
+    }
+    if (query->exec() && query->next()) {
+        version.databaseId = query->value(0).toLongLong();
+        version.generation = query->value(1).toLongLong();
+    } else {
+        qCCritical(lcSql) << "读取任务数据版本号失败：" << query->lastError().text();
+    }
+    query->finish();
+    return version;
+}
+
+bool SqlRepository::migrateSchema(int currentVersion)
+{
+    qCDebug(lcSql) << "当前数据库版本：" << currentVersion;
+    if (currentVersion >= schemaMigrations().last().version) {
+        return true; // 启动快速路径：结构已是最新
+    }
+
+    QSqlDatabase database = connection();
+    // 已越过v3的数据库以全文表是否存在为准：当时不支持trigram而跳过的，之后也不能创建引用它的触发器
+    const bool fullText = supportsFullTextTrigram(database) && (currentVersion < 3 || hasFullTextTable(database));
+    if (!fullText) {
+        qCWarning(lcSql) << "当前SQLite不支持FTS5 trigram分词或数据库中没有全文表，跳过全文索引迁移，搜索使用LIKE扫描";
+    }
+
+    for (const SchemaMigration &migration : schemaMigrations()) {
+        if (migration.version <= currentVersion) {
+            continue;
+        }
+
+        qCDebug(lcSql) << "执行数据库迁移 v" << migration.version << "：" << migration.description;
+        // 每个版本在单独事务中执行，失败时整体回滚，保证user_version与实际结构一致
+        if (!database.transaction()) {
+            qCCritical(lcSql) << "开启迁移事务失败：" << database.lastError().text();
+            return false;
+        }
+
+        // 迁移语句只执行一次，不进入预编译语句缓存
+        QSqlQuery query(database);
+        bool success = true;
+        QStringList statements = migration.statements;
+        if (fullText) {
+            statements += migration.fullTextStatements;
+        }
+        for (const QString &statement : std::as_const(statements)) {
+            if (!query.exec(statement)) {
+                qCCritical(lcSql) << "迁移SQL执行失败：" << statement << "，错误：" << query.lastError().text();
+                success = false;
+                break;
             }
-        } else {
-            qDebug() << "分类已存在：" << categoryName;
         }
+        // PRAGMA不支持参数绑定，版本号为内部常量，直接拼接
+        if (success && !query.exec(QString("PRAGMA user_version = %1").arg(migration.version))) {
+            qCCritical(lcSql) << "更新数据库版本失败：" << query.lastError().text();
+            success = false;
+        }
+        query.finish();
+
+        if (!success || !database.commit()) {
+            qCCritical(lcSql) << "数据库迁移 v" << migration.version << "失败，已回滚";
+            database.rollback();
+            return false;
+        }
+        currentVersion = migration.version;
     }
-    
-    // 再次查询所有分类，确认添加成功
-    query.exec("SELECT category_id, category_name FROM category ORDER BY category_id");
-    qDebug() << "最终分类列表：";
-    while (query.next()) {
-        qDebug() << "分类ID：" << query.value(0).toInt() << "，名称：" << query.value(1).toString();
+
+    qCDebug(lcSql) << "数据库结构已是最新版本：" << currentVersion;
+    return true;
+}
+
+SqlRepository::ThreadConnection::~ThreadConnection()
+{
+    // 语句必须先于连接释放，连接句柄的最后一个副本释放后才能移除
+    qDeleteAll(statements);
+    statements.clear();
+    QString connectionName = database.connectionName();
+    database.close();
+    database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+QString SqlRepository::nextConnectionName()
+{
+    // 连接名使用递增序号，线程ID可能被复用，不能作为连接名
+    static QAtomicInt connectionSerial;
+    return QString("SqlRepoConnection_%1").arg(connectionSerial.fetchAndAddRelaxed(1) + 1);
+}
+
+SqlRepository::ThreadConnection *SqlRepository::threadConnection()
+{
+    if (m_connections.hasLocalData()) {
+        return m_connections.localData();
+    }
+
+    QString connectionName = nextConnectionName();
+    ThreadConnection *threadConn = new ThreadConnection;
+    threadConn->database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    threadConn->database.setDatabaseName(m_databasePath);
+    if (openConnection(threadConn->database)) {
+        qCDebug(lcSql) << "线程" << QThread::currentThread() << "创建数据库连接：" << connectionName;
+    } else {
+        qCCritical(lcSql) << "线程" << QThread::currentThread() << "打开数据库连接失败："
+                    << threadConn->database.lastError().text();
     }
+    // 线程退出时QThreadStorage会自动delete，从而关闭并移除该连接
+    m_connections.setLocalData(threadConn);
+    return threadConn;
+}
 
+QSqlDatabase SqlRepository::connection()
+{
+    return threadConnection()->database;
+}
+
+bool SqlRepository::openConnection(QSqlDatabase &db)
+{
+    // 写锁被占用时最多等待5秒再返回SQLITE_BUSY
+    db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+    if (!db.open()) {
+        return false;
+    }
+
+    QSqlQuery pragmaQuery(db);
+    // WAL模式下读写互不阻塞：提醒线程等后台读取可与界面写入同时进行（该设置持久保存在数据库文件中）
+    if (!pragmaQuery.exec("PRAGMA journal_mode=WAL")) {
+        qCWarning(lcSql) << "启用WAL模式失败：" << pragmaQuery.lastError().text();
+    }
+    // WAL模式下NORMAL同步级别即可保证数据库一致性，减少fsync次数
+    if (!pragmaQuery.exec("PRAGMA synchronous=NORMAL")) {
+        qCWarning(lcSql) << "设置同步级别失败：" << pragmaQuery.lastError().text();
+    }
+    pragmaQuery.finish();
     return true;
 }
 
-bool SqlRepository::isConnected() const
+bool SqlRepository::isConnected()
 {
-    return database.isOpen();
+    return connection().isOpen();
+}
+
+void SqlRepository::releaseThreadConnection()
+{
+    if (m_connections.hasLocalData()) {
+        m_connections.setLocalData(nullptr); // 旧连接对象被自动delete
+    }
+}
+
+bool SqlRepository::beginReadTransaction()
+{
+    QSqlDatabase database = connection();
+    // 延迟事务在第一次读取时建立快照，之后的读取都基于该快照
+    if (!database.transaction()) {
+        qCCritical(lcSql) << "开启读事务失败：" << database.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void SqlRepository::endReadTransaction()
+{
+    QSqlDatabase database = connection();
+    // 事务内没有写入，提交即释放快照
+    if (!database.commit()) {
+        qCWarning(lcSql) << "结束读事务失败：" << database.lastError().text();
+        database.rollback();
+    }
 }
 
 QString SqlRepository::getDatabasePath() const
 {
-    return database.databaseName();
+    return m_databasePath;
 }
 
-bool SqlRepository::backupDatabase(const QString &backupPath)
+namespace {
+
+// 在线备份每步复制的页数：每步之间报告进度、检查取消，并短暂释放源库的锁
+constexpr int kBackupPagesPerStep = 256;
+constexpr int kBackupBusyRetryMs = 50;
+
+// 取得连接底层的sqlite3句柄，用于Qt未封装的SQLite接口（在线备份、中断查询）。
+// 句柄只能交给QSQLITE驱动所用的同一个SQLite库：版本不一致说明驱动内置了另一份SQLite（Qt未以-system-sqlite构建），
+// 此时返回nullptr，调用方退回只用SQL的做法
+sqlite3 *nativeHandle(const QSqlDatabase &database)
+{
+    QVariant handle = database.driver()->handle();
+    if (!handle.isValid() || qstrcmp(handle.typeName(), "sqlite3*") != 0) {
+        return nullptr;
+    }
+    static const bool sameLibrary = [&database]() {
+        QSqlQuery query(database);
+        bool same = query.exec("SELECT sqlite_version()") && query.next()
+                    && query.value(0).toString() == QLatin1String(sqlite3_libversion());
+        if (!same) {
+            qCWarning(lcSql) << "QSQLITE驱动与程序链接的SQLite版本不一致，在线备份与中断搜索不可用";
+        }
+        return same;
+    }();
+    return sameLibrary ? *static_cast<sqlite3 *const *>(handle.constData()) : nullptr;
+}
+
+// 语句是否因sqlite3_interrupt()而终止（属于取消而非错误）；驱动返回的是扩展错误码，低8位为主错误码
+bool isInterrupted(const QSqlQuery &query)
+{
+    return (query.lastError().nativeErrorCode().toInt() & 0xff) == SQLITE_INTERRUPT;
+}
+
+} // namespace
+
+bool SqlRepository::backupDatabase(const QString &backupPath,
+                                   const std::function<bool(qint64, qint64)> &onProgress)
 {
     // 检查备份路径是否为空
     if (backupPath.isEmpty()) {
-        qCritical() << "备份路径不能为空";
+        qCCritical(lcSql) << "备份路径不能为空";
+        return false;
+    }
+
+    // 不能备份到当前数据库文件本身
+    if (QFileInfo(backupPath).absoluteFilePath() == QFileInfo(m_databasePath).absoluteFilePath()) {
+        qCCritical(lcSql) << "备份路径不能与当前数据库相同：" << backupPath;
         return false;
     }
     
     // 检查数据库是否打开
+    QSqlDatabase database = connection();
     if (!database.isOpen()) {
-        qCritical() << "数据库未打开，无法备份";
+        qCCritical(lcSql) << "数据库未打开，无法备份";
         return false;
     }
-    
-    // 关闭数据库连接
-    bool wasOpen = database.isOpen();
-    database.close();
-    
-    // 复制数据库文件
-    QString currentPath = database.databaseName();
-    QFile::remove(backupPath); // 先删除已存在的备份文件
-    bool success = QFile::copy(currentPath, backupPath);
-    
-    if (success) {
-        qDebug() << "数据库备份成功，备份路径：" << backupPath;
+
+    // 先写入临时文件，成功后再替换旧备份，失败或取消时不会破坏已有备份
+    QString tempPath = backupPath + ".tmp";
+    QFile::remove(tempPath);
+
+    sqlite3 *source = nativeHandle(database);
+    if (!source) {
+        // 无法使用在线备份接口：VACUUM INTO单条语句完成复制，只在开始和结束时报告进度
+        qint64 bytesTotal = databaseSize();
+        if (onProgress && !onProgress(0, bytesTotal)) {
+            return false;
+        }
+        QSqlQuery query(database);
+        query.prepare("VACUUM INTO ?");
+        query.addBindValue(tempPath);
+        if (!query.exec()) {
+            qCCritical(lcSql) << "数据库备份失败：" << query.lastError().text();
+            QFile::remove(tempPath);
+            return false;
+        }
+        query.finish();
+        if (onProgress) {
+            onProgress(QFileInfo(tempPath).size(), bytesTotal);
+        }
     } else {
-        qCritical() << "数据库备份失败";
+        // 在本线程连接的读事务内分步复制：所有步骤读取同一个快照，备份期间其他连接照常读写（WAL模式），
+        // 写入不会使备份从头重来
+        if (!beginReadTransaction()) {
+            return false;
+        }
+        qint64 pageSize = 0;
+        QSqlQuery query(database);
+        if (query.exec("PRAGMA page_size") && query.next()) {
+            pageSize = query.value(0).toLongLong();
+        }
+        query.exec("SELECT 1 FROM sqlite_master LIMIT 1"); // 建立读快照
+        query.finish();
+
+        sqlite3 *target = nullptr;
+        int rc = sqlite3_open_v2(tempPath.toUtf8().constData(), &target, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                                 nullptr);
+        bool canceled = false;
+        if (rc == SQLITE_OK) {
+            sqlite3_backup *backup = sqlite3_backup_init(target, "main", source, "main");
+            if (backup) {
+                do {
+                    rc = sqlite3_backup_step(backup, kBackupPagesPerStep);
+                    qint64 pagesTotal = sqlite3_backup_pagecount(backup);
+                    qint64 pagesCopied = pagesTotal - sqlite3_backup_remaining(backup);
+                    if (onProgress && !onProgress(pagesCopied * pageSize, pagesTotal * pageSize)) {
+                        canceled = true;
+                        break;
+                    }
+                    if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+                        sqlite3_sleep(kBackupBusyRetryMs);
+                    }
+                } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+                sqlite3_backup_finish(backup);
+            } else {
+                rc = sqlite3_errcode(target);
+            }
+        }
+        if (!canceled && rc != SQLITE_DONE) {
+            qCCritical(lcSql) << "数据库备份失败：" << (target ? sqlite3_errmsg(target) : sqlite3_errstr(rc));
+        }
+        sqlite3_close(target);
+        endReadTransaction();
+
+        if (canceled || rc != SQLITE_DONE) {
+            QFile::remove(tempPath);
+            return false;
+        }
     }
-    
-    // 重新打开数据库连接
-    if (wasOpen && !database.open()) {
-        qCritical() << "备份后重新打开数据库失败：" << database.lastError().text();
+
+    QFile::remove(backupPath); // 先删除已存在的备份文件
+    if (!QFile::rename(tempPath, backupPath)) {
+        qCCritical(lcSql) << "数据库备份失败：无法写入备份文件" << backupPath;
+        QFile::remove(tempPath);
+        return false;
     }
-    
-    return success;
+
+    qCDebug(lcSql) << "数据库备份成功，备份路径：" << backupPath;
+    return true;
+}
+
+qint64 SqlRepository::databaseSize()
+{
+    QSqlQuery query(connection());
+    qint64 pageCount = 0;
+    qint64 pageSize = 0;
+    if (query.exec("PRAGMA page_count") && query.next()) {
+        pageCount = query.value(0).toLongLong();
+    }
+    if (query.exec("PRAGMA page_size") && query.next()) {
+        pageSize = query.value(0).toLongLong();
+    }
+    return pageCount * pageSize;
 }
 
 bool SqlRepository::restoreDatabase(const QString &backupPath)
 {
     // 检查备份文件是否存在
     if (!QFile::exists(backupPath)) {
-        qCritical() << "备份文件不存在：" << backupPath;
+        qCCritical(lcSql) << "备份文件不存在：" << backupPath;
         return false;
     }
     
-    // 关闭数据库连接
+    // 关闭数据库连接（缓存的语句依附于连接，需先释放）
+    QSqlDatabase &database = threadConnection()->database;
     bool wasOpen = database.isOpen();
+    clearStatementCache();
     database.close();
     
     // 复制备份文件到当前数据库路径
-    QString currentPath = database.databaseName();
+    QString currentPath = m_databasePath;
     QFile::remove(currentPath); // 先删除当前数据库文件
+    // 残留的WAL/共享内存文件属于旧库，必须一并删除，否则会被应用到恢复后的库上
+    QFile::remove(currentPath + "-wal");
+    QFile::remove(currentPath + "-shm");
     bool success = QFile::copy(backupPath, currentPath);
     
     if (success) {
-        qDebug() << "数据库恢复成功，恢复路径：" << backupPath;
+        qCDebug(lcSql) << "数据库恢复成功，恢复路径：" << backupPath;
     } else {
-        qCritical() << "数据库恢复失败";
+        qCCritical(lcSql) << "数据库恢复失败";
     }
     
     // 重新打开数据库连接
-    if (wasOpen && !database.open()) {
-        qCritical() << "恢复后重新打开数据库失败：" << database.lastError().text();
+    if (wasOpen && !openConnection(database)) {
+        qCCritical(lcSql) << "恢复后重新打开数据库失败：" << database.lastError().text();
+        return false;
+    }
+
+    // 备份可能来自旧版本程序，恢复后补齐结构迁移（索引、全文索引、统计表等）
+    if (wasOpen && !initTables()) {
+        qCCritical(lcSql) << "恢复后升级数据库结构失败";
         return false;
     }
+
+    // 恢复后的数据库与备份文件及原数据库都不再是同一份数据，重新生成标识，旧的任务快照不会被误用
+    if (wasOpen && success && !executeSql("UPDATE task_generation SET database_id = random() WHERE id = 1")) {
+        qCWarning(lcSql) << "恢复后更新数据库标识失败";
+    }
     
     return success;
 }
@@ -264,58 +698,173 @@ void SqlRepository::getTaskStatistics(int &totalTasks, int &completedTasks)
     totalTasks = 0;
     completedTasks = 0;
     
-    if (!database.isOpen()) {
-        qCritical() << "数据库未打开，无法获取任务统计信息";
+    if (!connection().isOpen()) {
+        qCCritical(lcSql) << "数据库未打开，无法获取任务统计信息";
         return;
     }
-    
-    QSqlQuery query(database);
-    
-    // 获取总任务数
-    if (query.exec("SELECT COUNT(*) FROM task")) {
-        if (query.next()) {
-            totalTasks = query.value(0).toInt();
-        }
-    } else {
-        qCritical() << "查询总任务数失败：" << query.lastError().text();
+
+    // 从触发器维护的汇总表读取（行数仅为分类数×优先级数），不再扫描task表
+    QSqlQuery *query = preparedQuery("SELECT IFNULL(SUM(total), 0), IFNULL(SUM(completed), 0) FROM task_stats");
+    if (!query) {
+        return;
     }
-    
-    // 获取已完成任务数
-    if (query.exec("SELECT COUNT(*) FROM task WHERE is_completed = 1")) {
-        if (query.next()) {
-            completedTasks = query.value(0).toInt();
-        }
+    if (query->exec() && query->next()) {
+        totalTasks = query->value(0).toInt();
+        completedTasks = query->value(1).toInt();
     } else {
-        qCritical() << "查询已完成任务数失败：" << query.lastError().text();
+        qCCritical(lcSql) << "查询任务统计失败：" << query->lastError().text();
     }
+    query->finish();
     
-    qDebug() << "任务统计信息：总任务数=" << totalTasks << "，已完成任务数=" << completedTasks;
+    qCDebug(lcSql) << "任务统计信息：总任务数=" << totalTasks << "，已完成任务数=" << completedTasks;
+}
+
+TaskStatistics SqlRepository::getTaskStatisticsBreakdown()
+{
+    TaskStatistics stats;
+    if (!connection().isOpen()) {
+        qCCritical(lcSql) << "数据库未打开，无法获取任务统计信息";
+        return stats;
+    }
+
+    // 总数与已完成数：直接读取汇总表
+    QSqlQuery *query = preparedQuery("SELECT category_id, priority, total, completed FROM task_stats WHERE total > 0");
+    if (!query) {
+        return stats;
+    }
+    if (!query->exec()) {
+        qCCritical(lcSql) << "查询任务统计失败：" << query->lastError().text();
+    }
+    while (query->next()) {
+        int categoryId = query->value(0).toInt();
+        int priority = query->value(1).toInt();
+        int total = query->value(2).toInt();
+        int completed = query->value(3).toInt();
+        stats.overall.total += total;
+        stats.overall.completed += completed;
+        stats.byCategory[categoryId].total += total;
+        stats.byCategory[categoryId].completed += completed;
+        stats.byPriority[priority].total += total;
+        stats.byPriority[priority].completed += completed;
+    }
+    query->finish();
+
+    // 逾期数随时间变化，无法由触发器维护：按(is_completed, deadline)索引只扫描已逾期的未完成任务
+    // 空值与汇总表一致记为-1
+    query = preparedQuery("SELECT IFNULL(category_id, -1), IFNULL(priority, -1), COUNT(*) FROM task "
+                          "WHERE is_completed = 0 AND deadline < ? GROUP BY 1, 2");
+    if (!query) {
+        return stats;
+    }
+    query->bindValue(0, QDateTime::currentSecsSinceEpoch());
+    if (!query->exec()) {
+        qCCritical(lcSql) << "查询逾期任务统计失败：" << query->lastError().text();
+    }
+    while (query->next()) {
+        int categoryId = query->value(0).toInt();
+        int priority = query->value(1).toInt();
+        int overdue = query->value(2).toInt();
+        stats.overall.overdue += overdue;
+        stats.byCategory[categoryId].overdue += overdue;
+        stats.byPriority[priority].overdue += overdue;
+    }
+    query->finish();
+    return stats;
 }
 
 bool SqlRepository::executeSql(const QString &sql, const QVariantList &bindValues)
 {
-    if (!database.isOpen()) {
-        qCritical() << "执行SQL失败：数据库未连接";
+    if (!connection().isOpen()) {
+        qCCritical(lcSql) << "执行SQL失败：数据库未连接";
         return false;
     }
 
-    QSqlQuery query(database);
-    query.prepare(sql);
-    foreach (const QVariant &value, bindValues) {
-        query.addBindValue(value);
+    QSqlQuery *query = preparedQuery(sql);
+    if (!query) {
+        return false;
+    }
+    // 按位置覆盖绑定值，复用语句时不会残留上一次的参数
+    for (int i = 0; i < bindValues.size(); ++i) {
+        query->bindValue(i, bindValues.at(i));
     }
 
-    if (!query.exec()) {
-        qCritical() << "SQL执行失败：" << sql << "，错误：" << query.lastError().text();
-        return false;
+    bool success = query->exec();
+    if (!success) {
+        qCCritical(lcSql) << "SQL执行失败：" << sql << "，错误：" << query->lastError().text();
     }
-    return true;
+    query->finish(); // 重置语句，释放读锁，供下次复用
+    return success;
+}
+
+QSqlQuery *SqlRepository::preparedQuery(const QString &sql)
+{
+    // 语句缓存按线程隔离，预编译语句只能在所属连接的线程中使用
+    ThreadConnection *threadConn = threadConnection();
+    if (threadConn->usedStatements && !threadConn->usedStatements->contains(sql)) {
+        threadConn->usedStatements->append(sql);
+    }
+    auto it = threadConn->statements.constFind(sql);
+    if (it != threadConn->statements.constEnd()) {
+        return it.value();
+    }
+
+    QSqlQuery *query = new QSqlQuery(threadConn->database);
+    query->setForwardOnly(true); // 结果只顺序读取一次，不缓存已读行
+    if (!query->prepare(sql)) {
+        qCCritical(lcSql) << "SQL预编译失败：" << sql << "，错误：" << query->lastError().text();
+        delete query;
+        return nullptr;
+    }
+    threadConn->statements.insert(sql, query);
+    return query;
+}
+
+QMap<QString, QStringList> SqlRepository::queryPlansFor(const std::function<void()> &action)
+{
+    ThreadConnection *threadConn = threadConnection();
+    QStringList usedStatements;
+    threadConn->usedStatements = &usedStatements;
+    action();
+    threadConn->usedStatements = nullptr;
+
+    // 语句执行后仍保留绑定值，按同样的参数取得计划，与实际执行时一致
+    QMap<QString, QStringList> plans;
+    for (const QString &sql : std::as_const(usedStatements)) {
+        QSqlQuery *statement = threadConn->statements.value(sql);
+        if (!statement) {
+            continue; // 预编译失败的语句，action中已输出错误
+        }
+        QSqlQuery explain(threadConn->database);
+        if (!explain.prepare("EXPLAIN QUERY PLAN " + sql)) {
+            qCWarning(lcSql) << "准备查询计划失败：" << sql << "，错误：" << explain.lastError().text();
+            continue;
+        }
+        const QVariantList bindValues = statement->boundValues();
+        for (int i = 0; i < bindValues.size(); ++i) {
+            explain.bindValue(i, bindValues.at(i));
+        }
+        QStringList details;
+        if (explain.exec()) {
+            while (explain.next()) {
+                details.append(explain.value(3).toString()); // 列：id, parent, notused, detail
+            }
+        }
+        plans.insert(sql, details);
+    }
+    return plans;
+}
+
+void SqlRepository::clearStatementCache()
+{
+    ThreadConnection *threadConn = threadConnection();
+    qDeleteAll(threadConn->statements);
+    threadConn->statements.clear();
 }
 
 QList<Category> SqlRepository::getAllCategories()
 {
     QList<Category> categories;
-    QSqlQuery query("SELECT category_id, category_name FROM category ORDER BY category_id", database);
+    QSqlQuery query("SELECT category_id, category_name FROM category ORDER BY category_id", connection());
 
     while (query.next()) {
         Category cat;
@@ -334,74 +883,235 @@ bool SqlRepository::addCategory(const QString &categoryName)
 bool SqlRepository::deleteCategory(int categoryId)
 {
     // 先检查分类是否存在
-    QSqlQuery existsQuery(database);
-    existsQuery.prepare("SELECT COUNT(*) FROM category WHERE category_id = ?");
-    existsQuery.addBindValue(categoryId);
-    
-    if (!existsQuery.exec() || !existsQuery.next() || existsQuery.value(0).toInt() == 0) {
-        qCritical() << "删除分类失败：分类不存在，ID=" << categoryId;
+    QSqlQuery *existsQuery = preparedQuery("SELECT COUNT(*) FROM category WHERE category_id = ?");
+    if (!existsQuery) {
+        return false;
+    }
+    existsQuery->bindValue(0, categoryId);
+
+    bool exists = existsQuery->exec() && existsQuery->next() && existsQuery->value(0).toInt() > 0;
+    existsQuery->finish();
+    if (!exists) {
+        qCCritical(lcSql) << "删除分类失败：分类不存在，ID=" << categoryId;
         return false;
     }
     
     // 执行删除操作
     bool success = executeSql("DELETE FROM category WHERE category_id = ?", {categoryId});
     if (success) {
-        qDebug() << "成功删除分类，ID=" << categoryId;
+        qCDebug(lcSql) << "成功删除分类，ID=" << categoryId;
     }
     return success;
 }
 
 bool SqlRepository::isCategoryUsed(int categoryId)
 {
-    QSqlQuery query(database);
-    query.prepare("SELECT COUNT(*) FROM task WHERE category_id = ?");
-    query.addBindValue(categoryId);
-    
-    if (!query.exec() || !query.next()) {
-        qCritical() << "检查分类使用情况失败，ID=" << categoryId;
+    QSqlQuery *query = preparedQuery("SELECT COUNT(*) FROM task WHERE category_id = ?");
+    if (!query) {
         return false;
     }
-    
-    bool isUsed = query.value(0).toInt() > 0;
-    qDebug() << "分类ID=" << categoryId << "，是否被使用：" << isUsed;
+    query->bindValue(0, categoryId);
+
+    if (!query->exec() || !query->next()) {
+        qCCritical(lcSql) << "检查分类使用情况失败，ID=" << categoryId;
+        query->finish();
+        return false;
+    }
+
+    bool isUsed = query->value(0).toInt() > 0;
+    query->finish();
+    qCDebug(lcSql) << "分类ID=" << categoryId << "，是否被使用：" << isUsed;
     return isUsed;
 }
 
-bool SqlRepository::addTask(const Task &task)
+namespace {
+
+// 单条与批量接口共用同一SQL文本，从而共用同一条缓存的预编译语句
+const QString kInsertTaskSql = "INSERT INTO task (title, description, deadline, priority, is_completed, category_id) VALUES (?, ?, ?, ?, ?, ?)";
+const QString kUpdateTaskSql = "UPDATE task SET title=?, description=?, deadline=?, priority=?, is_completed=?, category_id=? WHERE task_id=?";
+const QString kDeleteTaskSql = "DELETE FROM task WHERE task_id=?";
+const QString kMarkCompletedSql = "UPDATE task SET is_completed=? WHERE task_id=?";
+
+// 任务字段按INSERT/UPDATE语句的列顺序排列的绑定值
+QVariantList taskBindValues(const Task &task)
+{
+    return {
+        task.title,
+        task.description,
+        task.deadline.toSecsSinceEpoch(), // 截止时间以UTC秒级时间戳存储
+        task.priority,
+        task.isCompleted ? 1 : 0,
+        task.categoryId
+    };
+}
+
+// 所有任务查询统一的列顺序，与readTask()的下标对应
+const QString kTaskColumns = "task_id, title, description, deadline, priority, is_completed, category_id";
+
+// 从查询结果当前行解析任务（列顺序见kTaskColumns）
+Task readTask(const QSqlQuery &query)
 {
-    QString sql = "INSERT INTO task (title, description, deadline, priority, is_completed, category_id) VALUES (?, ?, ?, ?, ?, ?)";
-    return executeSql(sql, {
-                               task.title,
-                               task.description,
-                               task.deadline.toString("yyyy-MM-dd HH:mm:ss"),
-                               task.priority,
-                               task.isCompleted ? 1 : 0,
-                               task.categoryId
-                           });
+    Task task;
+    task.taskId = query.value(0).toInt();
+    task.title = query.value(1).toString();
+    task.description = query.value(2).toString();
+    // 截止时间为整数时间戳，直接换算，无需逐行解析日期字符串
+    task.deadline = QDateTime::fromSecsSinceEpoch(query.value(3).toLongLong());
+    task.priority = query.value(4).toInt();
+    task.isCompleted = query.value(5).toInt() == 1;
+    task.categoryId = query.value(6).toInt();
+    return task;
+}
+
+// 追加筛选条件（-1表示不筛选；completedFilter：1=未完成，2=已完成）
+void appendFilterClause(QString &sql, QVariantList &bindValues, int priority, int categoryId, int completedFilter)
+{
+    if (priority != -1) {
+        sql += " AND priority = ?";
+        bindValues.append(priority);
+    }
+    if (categoryId != -1) {
+        sql += " AND category_id = ?";
+        bindValues.append(categoryId);
+    }
+    if (completedFilter != -1) {
+        sql += " AND is_completed = ?";
+        bindValues.append(completedFilter == 1 ? 0 : 1); // 1=未完成(0), 2=已完成(1)
+    }
+}
+
+} // namespace
+
+bool SqlRepository::addTask(const Task &task, int *taskId)
+{
+    if (!taskId) {
+        return executeSql(kInsertTaskSql, taskBindValues(task));
+    }
+    // 需要新ID时走批量路径，在语句结束前读取lastInsertId
+    QList<int> insertedIds;
+    if (!executeBatch(kInsertTaskSql, QList<QVariantList>{taskBindValues(task)}, &insertedIds)) {
+        return false;
+    }
+    *taskId = insertedIds.value(0, -1);
+    return true;
 }
 
 bool SqlRepository::editTask(const Task &task)
 {
-    QString sql = "UPDATE task SET title=?, description=?, deadline=?, priority=?, is_completed=?, category_id=? WHERE task_id=?";
-    return executeSql(sql, {
-                               task.title,
-                               task.description,
-                               task.deadline.toString("yyyy-MM-dd HH:mm:ss"),
-                               task.priority,
-                               task.isCompleted ? 1 : 0,
-                               task.categoryId,
-                               task.taskId
-                           });
+    return executeSql(kUpdateTaskSql, taskBindValues(task) << task.taskId);
 }
 
 bool SqlRepository::deleteTask(int taskId)
 {
-    return executeSql("DELETE FROM task WHERE task_id=?", {taskId});
+    return executeSql(kDeleteTaskSql, {taskId});
 }
 
 bool SqlRepository::markTaskCompleted(int taskId, bool isCompleted)
 {
-    return executeSql("UPDATE task SET is_completed=? WHERE task_id=?", {isCompleted ? 1 : 0, taskId});
+    return executeSql(kMarkCompletedSql, {isCompleted ? 1 : 0, taskId});
+}
+
+QList<int> SqlRepository::addTasks(const QList<Task> &tasks)
+{
+    QList<QVariantList> rows;
+    rows.reserve(tasks.size());
+    for (const Task &task : tasks) {
+        rows.append(taskBindValues(task));
+    }
+
+    QList<int> insertedIds;
+    if (!executeBatch(kInsertTaskSql, rows, &insertedIds)) {
+        return QList<int>();
+    }
+    qCDebug(lcSql) << "批量添加任务成功，数量：" << insertedIds.size();
+    return insertedIds;
+}
+
+bool SqlRepository::updateTasks(const QList<Task> &tasks)
+{
+    QList<QVariantList> rows;
+    rows.reserve(tasks.size());
+    for (const Task &task : tasks) {
+        rows.append(taskBindValues(task) << task.taskId);
+    }
+    return executeBatch(kUpdateTaskSql, rows);
+}
+
+bool SqlRepository::deleteTasks(const QList<int> &taskIds)
+{
+    QList<QVariantList> rows;
+    rows.reserve(taskIds.size());
+    for (int taskId : taskIds) {
+        rows.append(QVariantList{taskId});
+    }
+    return executeBatch(kDeleteTaskSql, rows);
+}
+
+bool SqlRepository::setCompleted(const QList<int> &taskIds, bool isCompleted)
+{
+    QList<QVariantList> rows;
+    rows.reserve(taskIds.size());
+    for (int taskId : taskIds) {
+        rows.append(QVariantList{isCompleted ? 1 : 0, taskId});
+    }
+    return executeBatch(kMarkCompletedSql, rows);
+}
+
+bool SqlRepository::executeBatch(const QString &sql, const QList<QVariantList> &rows, QList<int> *insertedIds)
+{
+    if (rows.isEmpty()) {
+        return true;
+    }
+
+    QSqlDatabase database = connection();
+    if (!database.isOpen()) {
+        qCCritical(lcSql) << "批量执行SQL失败：数据库未连接";
+        return false;
+    }
+
+    QSqlQuery *query = preparedQuery(sql);
+    if (!query) {
+        return false;
+    }
+
+    // 整批只提交一次，避免逐行自动提交带来的逐行落盘开销
+    if (!database.transaction()) {
+        qCCritical(lcSql) << "开启批量事务失败：" << database.lastError().text();
+        return false;
+    }
+
+    if (insertedIds) {
+        insertedIds->reserve(insertedIds->size() + rows.size());
+    }
+    for (int row = 0; row < rows.size(); ++row) {
+        const QVariantList &bindValues = rows.at(row);
+        for (int i = 0; i < bindValues.size(); ++i) {
+            query->bindValue(i, bindValues.at(i));
+        }
+        if (!query->exec()) {
+            qCCritical(lcSql) << "批量SQL执行失败，第" << row + 1 << "行：" << sql << "，错误：" << query->lastError().text();
+            query->finish();
+            database.rollback();
+            if (insertedIds) {
+                insertedIds->clear();
+            }
+            return false;
+        }
+        if (insertedIds) {
+            insertedIds->append(query->lastInsertId().toInt());
+        }
+    }
+    query->finish();
+
+    if (!database.commit()) {
+        qCCritical(lcSql) << "提交批量事务失败：" << database.lastError().text();
+        database.rollback();
+        if (insertedIds) {
+            insertedIds->clear();
+        }
+        return false;
+    }
+    return true;
 }
 
 QList<Task> SqlRepository::getAllTasks()
@@ -409,169 +1119,335 @@ QList<Task> SqlRepository::getAllTasks()
     return getTasksByFilter(-1, -1, -1); // -1表示不筛选完成状态
 }
 
+Task SqlRepository::getTaskById(int taskId)
+{
+    Task task;
+    task.taskId = -1;
+
+    // 主键点查询，耗时与表大小无关
+    QSqlQuery *query = preparedQuery("SELECT " + kTaskColumns + " FROM task WHERE task_id = ?");
+    if (!query) {
+        return task;
+    }
+    query->bindValue(0, taskId);
+    if (!query->exec()) {
+        qCCritical(lcSql) << "按ID查询任务失败：" << query->lastError().text();
+    } else if (query->next()) {
+        task = readTask(*query);
+    }
+    query->finish();
+    return task;
+}
+
 QList<Task> SqlRepository::getTasksByFilter(int priority, int categoryId, int completedFilter)
 {
     QList<Task> tasks;
-    QString sql = "SELECT task_id, title, description, deadline, priority, is_completed, category_id FROM task WHERE 1=1";
+    QString sql = "SELECT " + kTaskColumns + " FROM task WHERE 1=1";
     QVariantList bindValues;
 
     if (priority != -1) {
-        sql += " AND priority = ?";
-        bindValues.append(priority);
-        qDebug() << "筛选优先级：" << priority;
+        qCDebug(lcSql) << "筛选优先级：" << priority;
     }
     if (categoryId != -1) {
-        sql += " AND category_id = ?";
-        bindValues.append(categoryId);
-        qDebug() << "筛选分类ID：" << categoryId;
+        qCDebug(lcSql) << "筛选分类ID：" << categoryId;
     }
-
-    // 根据completedFilter决定是否添加完成状态筛选
     if (completedFilter != -1) {
-        sql += " AND is_completed = ?";
-        bindValues.append(completedFilter == 1 ? 0 : 1); // 1=未完成(0), 2=已完成(1)
-        qDebug() << "筛选完成状态：" << (completedFilter == 1 ? "未完成" : "已完成");
+        qCDebug(lcSql) << "筛选完成状态：" << (completedFilter == 1 ? "未完成" : "已完成");
     } else {
-        qDebug() << "不筛选完成状态";
+        qCDebug(lcSql) << "不筛选完成状态";
     }
+    appendFilterClause(sql, bindValues, priority, categoryId, completedFilter);
 
     sql += " ORDER BY deadline ASC";
-    qDebug() << "执行的SQL：" << sql;
-    qDebug() << "绑定参数：" << bindValues;
+    qCDebug(lcSql) << "执行的SQL：" << sql;
+    qCDebug(lcSql) << "绑定参数：" << bindValues;
 
-    QSqlQuery query(database);
-    query.prepare(sql);
-    foreach (const QVariant &value, bindValues) {
-        query.addBindValue(value);
+    // 筛选条件组合有限（最多8种），每种SQL形态各缓存一条预编译语句
+    QSqlQuery *query = preparedQuery(sql);
+    if (!query) {
+        return tasks;
+    }
+    for (int i = 0; i < bindValues.size(); ++i) {
+        query->bindValue(i, bindValues.at(i));
     }
 
-    if (!query.exec()) {
-        qCritical() << "任务查询失败：" << query.lastError().text();
+    if (!query->exec()) {
+        qCCritical(lcSql) << "任务查询失败：" << query->lastError().text();
+        query->finish();
         return tasks;
     }
 
     int taskCount = 0;
     // 直接遍历查询结果
-    while (query.next()) {
-        Task task;
-        task.taskId = query.value(0).toInt();
-        task.title = query.value(1).toString();
-        task.description = query.value(2).toString();
-
-        // 调试：输出查询到的原始数据
-        qDebug() << "查询到任务：ID=" << task.taskId << "，标题=" << task.title
-                 << "，完成状态=" << query.value(5).toInt();
-
-        // 解析日期时间，兼容不同格式
-        QString deadlineStr = query.value(3).toString();
-        QDateTime deadline;
-        if (deadlineStr.contains(":")) {
-            // 尝试多种格式解析
-            if (deadlineStr.count(":") == 2) {
-                deadline = QDateTime::fromString(deadlineStr, "yyyy-MM-dd HH:mm:ss");
-            } else {
-                deadline = QDateTime::fromString(deadlineStr, "yyyy-MM-dd HH:mm");
-            }
-        }
-        task.deadline = deadline;
-        task.priority = query.value(4).toInt();
-        task.isCompleted = query.value(5).toInt() == 1;
-        task.categoryId = query.value(6).toInt();
+    while (query->next()) {
+        Task task = readTask(*query);
+
+        // 调试：输出查询到的原始数据（发布构建中不编译）
+        qCTraceRow() << "查询到任务：ID=" << task.taskId << "，标题=" << task.title
+                 << "，完成状态=" << task.isCompleted;
+
         tasks.append(task);
         taskCount++;
     }
-    qDebug() << "查询到的任务数：" << taskCount;
+    query->finish();
+    qCDebug(lcSql) << "查询到的任务数：" << taskCount;
 
-    // 如果没有查询到任务，尝试查询所有任务（不包含筛选条件）用于调试
-    if (taskCount == 0) {
-        QSqlQuery allQuery(database);
+    // 如果没有查询到任务，尝试查询所有任务（不包含筛选条件）用于调试，仅在开启调试日志时执行
+    if (taskCount == 0 && lcSql().isDebugEnabled()) {
+        QSqlQuery allQuery(connection());
         allQuery.exec("SELECT COUNT(*) FROM task");
         if (allQuery.next()) {
-            qDebug() << "数据库中总任务数：" << allQuery.value(0).toInt();
+            qCDebug(lcSql) << "数据库中总任务数：" << allQuery.value(0).toInt();
         }
     }
     return tasks;
 }
 
-QList<Task> SqlRepository::searchTasks(const QString &keyword)
+QList<Task> SqlRepository::getTasksPage(int priority, int categoryId, int completedFilter,
+                                        const TaskCursor &after, int limit)
 {
     QList<Task> tasks;
-    QString sql = "SELECT task_id, title, description, deadline, priority, is_completed, category_id "
-                  "FROM task WHERE title LIKE ? OR description LIKE ? ORDER BY deadline ASC";
-    
+    QString sql = "SELECT " + kTaskColumns + " FROM task WHERE 1=1";
+    QVariantList bindValues;
+    appendFilterClause(sql, bindValues, priority, categoryId, completedFilter);
+
+    // 键集分页：从上一页最后一行(deadline, task_id)之后继续读取，避免OFFSET逐行跳过
+    // 必须使用行值比较：SQLite能把它转换为索引(…, deadline)上的deadline>?范围起点直接定位
+    // （索引隐含rowid即task_id作为最后一列）；展开成OR形式时优化器不会用它限定范围，每页都从索引开头扫描
+    if (!after.isStart()) {
+        sql += " AND (deadline, task_id) > (?, ?)";
+        bindValues << after.deadline.toSecsSinceEpoch() << after.taskId;
+    }
+    sql += " ORDER BY deadline ASC, task_id ASC LIMIT ?";
+    bindValues.append(limit);
+
+    QSqlQuery *query = preparedQuery(sql);
+    if (!query) {
+        return tasks;
+    }
+    for (int i = 0; i < bindValues.size(); ++i) {
+        query->bindValue(i, bindValues.at(i));
+    }
+
+    if (!query->exec()) {
+        qCCritical(lcSql) << "分页查询任务失败：" << query->lastError().text();
+        query->finish();
+        return tasks;
+    }
+
+    tasks.reserve(limit);
+    while (query->next()) {
+        tasks.append(readTask(*query));
+    }
+    query->finish();
+    return tasks;
+}
+
+int SqlRepository::countTasksByFilter(int priority, int categoryId, int completedFilter)
+{
+    QString sql = "SELECT COUNT(*) FROM task WHERE 1=1";
+    QVariantList bindValues;
+    appendFilterClause(sql, bindValues, priority, categoryId, completedFilter);
+
+    QSqlQuery *query = preparedQuery(sql);
+    if (!query) {
+        return 0;
+    }
+    for (int i = 0; i < bindValues.size(); ++i) {
+        query->bindValue(i, bindValues.at(i));
+    }
+
+    int count = 0;
+    if (query->exec() && query->next()) {
+        count = query->value(0).toInt();
+    } else {
+        qCCritical(lcSql) << "统计筛选任务数失败：" << query->lastError().text();
+    }
+    query->finish();
+    return count;
+}
+
+QList<Task> SqlRepository::searchTasks(const QString &keyword, QHash<int, QString> *snippets,
+                                       const std::function<bool()> &isCanceled)
+{
+    // 登记本线程的连接，搜索被取代时interruptSearch()可中断正在执行的语句（排序和LIMIT使大部分工作
+    // 发生在返回第一行之前，只在行之间检查isCanceled无法及时停止）
+    {
+        QMutexLocker locker(&m_searchMutex);
+        m_searchHandle = nativeHandle(connection());
+    }
+    QList<Task> tasks;
+    if (!isCanceled || !isCanceled()) {
+        tasks = usesFullTextIndex(keyword) ? searchTasksByFullText(keyword, snippets, isCanceled)
+                                           : searchTasksByLike(keyword, isCanceled);
+    }
+    // 清除登记之后，晚到的中断请求不会再作用于本连接上的后续操作
+    {
+        QMutexLocker locker(&m_searchMutex);
+        m_searchHandle = nullptr;
+    }
+    return tasks;
+}
+
+void SqlRepository::interruptSearch()
+{
+    QMutexLocker locker(&m_searchMutex);
+    if (m_searchHandle) {
+        sqlite3_interrupt(m_searchHandle);
+    }
+}
+
+QList<Task> SqlRepository::searchTasksByFullText(const QString &keyword, QHash<int, QString> *snippets,
+                                                 const std::function<bool()> &isCanceled)
+{
+    QList<Task> tasks;
+    // 按bm25相关度排序，并生成带高亮标记的摘要（-1表示自动选择匹配最好的列）
+    QString sql = "SELECT t.task_id, t.title, t.description, t.deadline, t.priority, t.is_completed, t.category_id, "
+                  "snippet(task_fts, -1, '【', '】', '…', 16) "
+                  "FROM task_fts JOIN task t ON t.task_id = task_fts.rowid "
+                  "WHERE task_fts MATCH ? ORDER BY rank LIMIT ?";
+
+    // 关键字整体作为FTS5短语，避免其中的引号、AND/OR等被解析为查询语法
+    QString matchExpr = "\"" + QString(keyword).replace("\"", "\"\"") + "\"";
+
+    qCDebug(lcSql) << "执行全文搜索，关键字：" << keyword;
+    qCDebug(lcSql) << "匹配表达式：" << matchExpr;
+
+    QSqlQuery *query = preparedQuery(sql);
+    if (!query) {
+        return tasks;
+    }
+    query->bindValue(0, matchExpr);
+    query->bindValue(1, kSearchResultLimit);
+
+    if (!query->exec()) {
+        if (isInterrupted(*query)) {
+            qCDebug(lcSql) << "搜索已中断，关键字：" << keyword;
+        } else {
+            qCCritical(lcSql) << "全文搜索失败：" << query->lastError().text();
+        }
+        query->finish();
+        return tasks;
+    }
+
+    while (query->next()) {
+        // 已被取代的搜索不再逐行读取（执行中的语句由interruptSearch()中断）
+        if (isCanceled && isCanceled()) {
+            qCDebug(lcSql) << "搜索已取消，关键字：" << keyword;
+            query->finish();
+            if (snippets) {
+                snippets->clear();
+            }
+            return QList<Task>();
+        }
+        Task task = readTask(*query);
+        if (snippets) {
+            snippets->insert(task.taskId, query->value(7).toString());
+        }
+        tasks.append(task);
+    }
+    if (isInterrupted(*query)) {
+        qCDebug(lcSql) << "搜索已中断，关键字：" << keyword;
+        query->finish();
+        if (snippets) {
+            snippets->clear();
+        }
+        return QList<Task>();
+    }
+    query->finish();
+
+    qCDebug(lcSql) << "搜索到的任务数：" << tasks.size();
+    return tasks;
+}
+
+bool SqlRepository::usesFullTextIndex(const QString &keyword)
+{
+    // trigram分词至少需要3个字符才能命中全文索引，更短的关键字退回LIKE扫描
+    if (keyword.toUcs4().size() < 3) {
+        return false;
+    }
+    // 迁移时SQLite不支持trigram的数据库没有全文表（恢复的备份也可能没有），每次查询结构表确认
+    QSqlQuery *query = preparedQuery("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'task_fts'");
+    if (!query) {
+        return false;
+    }
+    bool exists = query->exec() && query->next();
+    query->finish();
+    return exists;
+}
+
+QList<Task> SqlRepository::searchTasksByLike(const QString &keyword, const std::function<bool()> &isCanceled)
+{
+    QList<Task> tasks;
+    QString sql = "SELECT " + kTaskColumns + " FROM task WHERE title LIKE ? OR description LIKE ? ORDER BY deadline ASC LIMIT ?";
+
     QString searchPattern = "%" + keyword + "%";
-    QVariantList bindValues = {searchPattern, searchPattern};
-    
-    qDebug() << "执行任务搜索，关键字：" << keyword;
-    qDebug() << "搜索模式：" << searchPattern;
-    qDebug() << "执行的SQL：" << sql;
+    QVariantList bindValues = {searchPattern, searchPattern, kSearchResultLimit};
+
+    qCDebug(lcSql) << "执行任务搜索，关键字：" << keyword;
+    qCDebug(lcSql) << "搜索模式：" << searchPattern;
+    qCDebug(lcSql) << "执行的SQL：" << sql;
     
-    QSqlQuery query(database);
-    query.prepare(sql);
-    foreach (const QVariant &value, bindValues) {
-        query.addBindValue(value);
+    QSqlQuery *query = preparedQuery(sql);
+    if (!query) {
+        return tasks;
     }
-    
-    if (!query.exec()) {
-        qCritical() << "任务搜索失败：" << query.lastError().text();
+    for (int i = 0; i < bindValues.size(); ++i) {
+        query->bindValue(i, bindValues.at(i));
+    }
+
+    if (!query->exec()) {
+        if (isInterrupted(*query)) {
+            qCDebug(lcSql) << "搜索已中断，关键字：" << keyword;
+        } else {
+            qCCritical(lcSql) << "任务搜索失败：" << query->lastError().text();
+        }
+        query->finish();
         return tasks;
     }
     
     int taskCount = 0;
-    while (query.next()) {
-        Task task;
-        task.taskId = query.value(0).toInt();
-        task.title = query.value(1).toString();
-        task.description = query.value(2).toString();
-        
-        // 解析日期时间
-        QString deadlineStr = query.value(3).toString();
-        QDateTime deadline;
-        if (deadlineStr.contains(":")) {
-            if (deadlineStr.count(":") == 2) {
-                deadline = QDateTime::fromString(deadlineStr, "yyyy-MM-dd HH:mm:ss");
-            } else {
-                deadline = QDateTime::fromString(deadlineStr, "yyyy-MM-dd HH:mm");
-            }
+    while (query->next()) {
+        if (isCanceled && isCanceled()) {
+            qCDebug(lcSql) << "搜索已取消，关键字：" << keyword;
+            query->finish();
+            return QList<Task>();
         }
-        task.deadline = deadline;
-        task.priority = query.value(4).toInt();
-        task.isCompleted = query.value(5).toInt() == 1;
-        task.categoryId = query.value(6).toInt();
-        
-        tasks.append(task);
+        tasks.append(readTask(*query));
         taskCount++;
     }
-    
-    qDebug() << "搜索到的任务数：" << taskCount;
+    if (isInterrupted(*query)) {
+        qCDebug(lcSql) << "搜索已中断，关键字：" << keyword;
+        query->finish();
+        return QList<Task>();
+    }
+    query->finish();
+
+    qCDebug(lcSql) << "搜索到的任务数：" << taskCount;
     return tasks;
 }
 
 QList<Task> SqlRepository::getPendingTasksWithReminder(int reminderMinutes)
 {
     QList<Task> tasks;
-    QString sql = R"(
-        SELECT task_id, title, description, deadline, priority, is_completed, category_id
-        FROM task
-        WHERE is_completed=0 AND deadline BETWEEN datetime('now') AND datetime('now', '+' || ? || ' minutes')
-        ORDER BY deadline ASC
-    )";
+    QString sql = "SELECT " + kTaskColumns + " FROM task "
+                  "WHERE is_completed=0 AND deadline BETWEEN ? AND ? ORDER BY deadline ASC";
 
-    QSqlQuery query(database);
-    query.prepare(sql);
-    query.addBindValue(reminderMinutes);
-    query.exec();
+    QSqlQuery *query = preparedQuery(sql);
+    if (!query) {
+        return tasks;
+    }
+    // 时间范围按整数时间戳比较，走(is_completed, deadline)索引
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    query->bindValue(0, now);
+    query->bindValue(1, now + qint64(reminderMinutes) * 60);
+    if (!query->exec()) {
+        qCCritical(lcSql) << "提醒任务查询失败：" << query->lastError().text();
+    }
 
-    while (query.next()) {
-        Task task;
-        task.taskId = query.value(0).toInt();
-        task.title = query.value(1).toString();
-        task.description = query.value(2).toString();
-        task.deadline = QDateTime::fromString(query.value(3).toString(), "yyyy-MM-dd HH:mm:ss");
-        task.priority = query.value(4).toInt();
-        task.isCompleted = false;
-        task.categoryId = query.value(6).toInt();
-        tasks.append(task);
+    while (query->next()) {
+        tasks.append(readTask(*query));
     }
+    query->finish();
     return tasks;
 }
@@ -9,6 +9,13 @@
 #include <QVariant>
 #include <QDebug>
 #include <QList>
+#include <QHash>
+#include <QMap>
+#include <QThreadStorage>
+#include <QMutex>
+#include <functional>
+
+struct sqlite3;
 
 // 任务结构体（数据传输载体）
 struct Task {
@@ -27,6 +34,42 @@ struct Category {
     QString categoryName;// 分类名称（工作/学习/生活等）
 };
 
+// 任务计数（总数/已完成/已逾期）
+struct TaskCounts {
+    int total = 0;       // 任务总数
+    int completed = 0;   // 已完成数
+    int overdue = 0;     // 未完成且已过截止时间的任务数
+};
+
+// 任务统计明细
+struct TaskStatistics {
+    TaskCounts overall;              // 全部任务
+    QMap<int, TaskCounts> byCategory; // 分类ID -> 计数
+    QMap<int, TaskCounts> byPriority; // 优先级 -> 计数
+};
+
+// 键集分页游标：上一页最后一行的(截止时间, 任务ID)
+struct TaskCursor {
+    QDateTime deadline;  // 上一页最后一行的截止时间
+    int taskId = -1;     // 上一页最后一行的任务ID，-1表示从第一页开始
+
+    bool isStart() const { return taskId < 0; }
+};
+
+// 任务数据版本：数据库标识（建库、升级或恢复时随机生成）+ 任务数据版本号（任务每次增删改都会递增）
+// 两者都相同才说明是同一个数据库的同一份任务数据（换用另一个数据库文件时版本号可能恰好相同）
+struct DataVersion {
+    qint64 databaseId = 0;
+    qint64 generation = -1; // -1表示读取失败
+
+    bool isValid() const { return generation >= 0; }
+    bool operator==(const DataVersion &other) const
+    {
+        return databaseId == other.databaseId && generation == other.generation;
+    }
+    bool operator!=(const DataVersion &other) const { return !(*this == other); }
+};
+
 class SqlRepository : public QObject
 {
     Q_OBJECT
@@ -37,10 +80,16 @@ public:
         return instance;
     }
 
-    explicit SqlRepository(QObject *parent = nullptr);
+    explicit SqlRepository(QObject *parent = nullptr); // 使用程序目录下的TaskManager.db
+    explicit SqlRepository(const QString &databasePath, QObject *parent = nullptr); // 使用指定的数据库文件（测试）
 
-    // 数据库连接状态
-    bool isConnected() const;
+    // 数据库连接状态（当前线程的连接）
+    bool isConnected();
+    // 释放当前线程的数据库连接（后台线程空闲或退出前调用，下次访问时自动重建）
+    void releaseThreadConnection();
+    // 在当前线程的连接上开启/结束只读事务：期间的所有查询看到同一个数据库快照（WAL模式下不阻塞其他连接写入）
+    bool beginReadTransaction();
+    void endReadTransaction();
 
     // 分类相关接口
     QList<Category> getAllCategories(); // 获取所有分类
@@ -49,24 +98,53 @@ public:
     bool isCategoryUsed(int categoryId); // 检查分类是否被任务使用
 
     // 任务相关接口
-    bool addTask(const Task &task); // 添加任务
+    bool addTask(const Task &task, int *taskId = nullptr); // 添加任务，taskId非空时返回新任务ID
     
     ~SqlRepository(); // 析构函数
     bool editTask(const Task &task); // 编辑任务
     bool deleteTask(int taskId); // 删除任务
     bool markTaskCompleted(int taskId, bool isCompleted); // 标记任务完成状态
     QList<Task> getAllTasks(); // 获取所有任务
+    Task getTaskById(int taskId); // 按主键获取单个任务，不存在时taskId为-1
     QList<Task> getTasksByFilter(int priority, int categoryId, int completedFilter); // 按条件筛选任务，-1表示不筛选完成状态
-    QList<Task> searchTasks(const QString &keyword); // 按标题或描述模糊搜索任务
+    // 分页筛选：返回游标after之后按(截止时间, 任务ID)排序的最多limit条任务
+    QList<Task> getTasksPage(int priority, int categoryId, int completedFilter, const TaskCursor &after, int limit);
+    int countTasksByFilter(int priority, int categoryId, int completedFilter); // 统计筛选结果总数
+    // 按标题或描述搜索任务（全文索引，按相关度排序）；snippets非空时返回任务ID->高亮摘要
+    // isCanceled非空时在读取结果期间检查，返回true则停止读取并返回空列表（搜索已被新的请求取代）
+    QList<Task> searchTasks(const QString &keyword, QHash<int, QString> *snippets = nullptr,
+                            const std::function<bool()> &isCanceled = nullptr);
+    // 中断正在执行的searchTasks（可在任意线程调用），被中断的搜索返回空列表；没有进行中的搜索时不做任何事
+    void interruptSearch();
+    static constexpr int kSearchResultLimit = 1000; // 单次搜索最多返回的任务数（结果少于此数时为完整结果）
+    // 该关键字是否使用全文索引搜索（至少3个字符且数据库中有全文表），否则使用LIKE扫描
+    bool usesFullTextIndex(const QString &keyword);
     QList<Task> getPendingTasksWithReminder(int reminderMinutes); // 获取需提醒的未完成任务
+
+    // 批量任务接口：整批在一个事务中执行并复用同一条预编译语句，任一行失败则整体回滚
+    QList<int> addTasks(const QList<Task> &tasks); // 批量添加，按输入顺序返回新任务ID，失败返回空列表
+    bool updateTasks(const QList<Task> &tasks); // 批量编辑（按taskId）
+    bool deleteTasks(const QList<int> &taskIds); // 批量删除
+    bool setCompleted(const QList<int> &taskIds, bool isCompleted); // 批量标记完成状态
     
     // 数据库备份/恢复接口
-    bool backupDatabase(const QString &backupPath); // 备份数据库
+    // 在线备份数据库（不关闭连接，可在任意线程调用）：按页分步复制，每步后以(已复制字节数, 总字节数)调用onProgress，
+    // 返回false时取消；先写入backupPath.tmp，完成后再替换backupPath，失败或取消时已有备份保持不变
+    bool backupDatabase(const QString &backupPath,
+                        const std::function<bool(qint64 bytesCopied, qint64 bytesTotal)> &onProgress = nullptr);
     bool restoreDatabase(const QString &backupPath); // 恢复数据库
     QString getDatabasePath() const; // 获取当前数据库路径
+    qint64 databaseSize(); // 数据库当前大小（字节，页数×页大小）
+    int schemaVersion(); // 获取数据库结构版本（PRAGMA user_version），失败返回-1
+    DataVersion dataVersion(); // 获取任务数据版本，失败时generation为-1
+
+    // 查询计划（测试用）：在当前线程执行action，返回其间经预编译语句缓存执行的每条语句
+    // 按最近一次绑定值得到的EXPLAIN QUERY PLAN明细（SQL文本 -> 计划各行的detail列）；action中不能释放当前线程的连接
+    QMap<QString, QStringList> queryPlansFor(const std::function<void()> &action);
     
     // 统计接口
     void getTaskStatistics(int &totalTasks, int &completedTasks); // 获取任务完成统计
+    TaskStatistics getTaskStatisticsBreakdown(); // 获取按分类、优先级划分的统计（含逾期数）
 
 signals:
     void statusUpdated(const QString &status);
@@ -75,11 +153,41 @@ private:
     SqlRepository(SqlRepository const &) = delete;
     void operator=(SqlRepository const &) = delete;
 
-    QSqlDatabase database; // 数据库连接对象
+    // 单个线程持有的数据库连接及其预编译语句缓存
+    // Qt要求QSqlDatabase只能在创建它的线程中使用，因此每个线程各自建立一条命名连接
+    struct ThreadConnection {
+        QSqlDatabase database;                  // 本线程的数据库连接
+        QHash<QString, QSqlQuery *> statements; // 预编译语句缓存（键为SQL文本）
+        QStringList *usedStatements = nullptr;  // queryPlansFor()执行期间记录用到的语句
+        ~ThreadConnection();                    // 线程退出时释放语句并移除连接
+    };
+
+    QString m_databasePath;                           // 数据库文件路径
+    QThreadStorage<ThreadConnection *> m_connections; // 每线程一条连接，首次使用时创建
+    QMutex m_searchMutex;                             // 保护m_searchHandle
+    sqlite3 *m_searchHandle = nullptr;                // 正在执行搜索的连接（没有搜索或无法取得句柄时为空）
+
+    ThreadConnection *threadConnection(); // 获取（必要时创建）当前线程的连接
+    QSqlDatabase connection();            // 当前线程的数据库连接
+    bool openConnection(QSqlDatabase &db); // 打开连接并设置WAL等连接参数
 
-    void initDatabase(); // 初始化数据库连接（对应idatabase风格）
+    void initDatabase(const QString &databasePath); // 初始化数据库连接（对应idatabase风格）
+    static QString nextConnectionName(); // 分配不重复的连接名（多个实例、多个线程的连接互不冲突）
+    void logDiagnostics(QSqlDatabase &database); // 输出数据库诊断信息（仅在开启taskmanager.sql.diagnostics时调用）
     bool initTables();    // 初始化数据表（拆分原initDatabase功能）
+    bool migrateSchema(int currentVersion); // 从currentVersion起依次执行未完成的结构迁移
+    bool seedDefaultCategories(); // 写入默认分类（仅新建数据库时调用）
+    QList<Task> searchTasksByFullText(const QString &keyword, QHash<int, QString> *snippets,
+                                      const std::function<bool()> &isCanceled);
+    // 关键字过短或数据库没有全文索引时的LIKE扫描搜索
+    QList<Task> searchTasksByLike(const QString &keyword, const std::function<bool()> &isCanceled);
     bool executeSql(const QString &sql, const QVariantList &bindValues = QVariantList());
+    // 在单个事务中逐行执行同一条语句，insertedIds非空时收集每行的自增ID
+    bool executeBatch(const QString &sql, const QList<QVariantList> &rows, QList<int> *insertedIds = nullptr);
+    // 获取已预编译的语句（首次使用时prepare并缓存），失败返回nullptr
+    QSqlQuery *preparedQuery(const QString &sql);
+    // 释放当前线程缓存的所有语句（关闭连接前必须调用）
+    void clearStatementCache();
 };
 
 #endif // SQLREPOSITORY_H
@@ -1,50 +1,112 @@
 #include "taskmanager.h"
 #include "reminderthread.h"
-#include "fileexporter.h"
+#include "backupthread.h"
+#include "exportthread.h"
+#include "logging.h"
+#include <QtConcurrent>
+#include <QTimer>
+#include <QPromise>
+#include <memory>
 
 TaskManager::TaskManager(QObject *parent)
     : QObject(parent)
     , m_repo(SqlRepository::getInstance())
 {
     m_sqlRepo = &m_repo; // 初始化m_sqlRepo为单例指针
+    // 单线程工作池：所有异步数据库操作串行执行，线程常驻以复用其数据库连接
+    m_dbWorker.setMaxThreadCount(1);
+    m_dbWorker.setExpiryTimeout(-1);
+    // 任务变化后延迟写入快照，连续修改只写一次
+    m_snapshotTimer = new QTimer(this);
+    m_snapshotTimer->setSingleShot(true);
+    m_snapshotTimer->setInterval(kSnapshotDelayMs);
+    connect(m_snapshotTimer, &QTimer::timeout, this, &TaskManager::writeSnapshot);
     m_reminderThread = new ReminderThread(this);
-    m_fileExporter = new FileExporter(this);
 
     // 连接线程提醒信号
     connect(m_reminderThread, &ReminderThread::taskReminder, this, &TaskManager::onThreadReminder);
     // 连接数据库状态信号
     connect(m_sqlRepo, &SqlRepository::statusUpdated, this, &TaskManager::statusUpdated);
     if (!m_repo.isConnected()) {
-        qCritical() << "数据库单例连接失败！";
+        qCCritical(lcSql) << "数据库单例连接失败！";
     }
 }
 
 TaskManager::~TaskManager()
 {
-    // 停止线程
+    // 等待已提交的异步数据库操作（包括排队中的写入）执行完毕
+    m_dbWorker.waitForDone();
+    // 有未写入的变化时同步写入快照，下次启动可直接使用；
+    // 仍有未应用到内存任务库的异步写入时，内存内容与数据库不一致，不写入
+    m_snapshotWrite.waitForFinished();
+    if (m_snapshotTimer->isActive() && m_pendingWrites == 0) {
+        DataVersion version = m_sqlRepo->dataVersion();
+        if (version.isValid()) {
+            TaskSnapshot::write(m_snapshot.nextWritePath(snapshotBasePath()), m_store.tasks(), version,
+                                m_snapshot.takeNextSequence());
+        }
+    }
+    // 停止线程（提醒线程被立即唤醒退出）
     if (m_reminderThread->isRunning()) {
         m_reminderThread->stop();
         m_reminderThread->wait();
     }
+    // 取消进行中的备份（临时文件由备份线程删除，已有的备份文件不受影响）
+    if (m_backupThread) {
+        m_backupThread->cancel();
+        m_backupThread->wait();
+    }
+    // 取消进行中的导出（部分文件由导出线程删除）
+    if (m_exportThread) {
+        m_exportThread->cancel();
+        m_exportThread->wait();
+    }
 }
 
 void TaskManager::init()
 {
     // 加载分类列表
-    m_categories = m_sqlRepo->getAllCategories();
-    emit categoriesChanged(m_categories); // 发出分类变化信号，通知UI更新
+    m_categories = CategoryDictionary(m_sqlRepo->getAllCategories());
+    emit categoriesChanged(m_categories.categories()); // 发出分类变化信号，通知UI更新
     emit statusUpdated(m_sqlRepo->isConnected() ? "数据库连接正常" : "数据库连接失败");
 
-    // 启动提醒线程（定时查询需提醒任务）
+    // 优先从内存映射的快照文件加载任务（不经过SQL解析），界面可立即显示；
+    // 快照版本号与数据库不一致时先显示快照内容，再在后台从SQLite重新加载
+    QList<Task> snapshotTasks;
+    bool snapshotLoaded = m_snapshot.openLatest(snapshotBasePath()) && m_snapshot.readTasks(&snapshotTasks);
+    m_snapshot.close(); // 任务文本已复制，映射不再需要
+    if (snapshotLoaded) {
+        m_store.load(snapshotTasks);
+        DataVersion version = m_sqlRepo->dataVersion();
+        qCDebug(lcSql) << "内存任务库已从快照加载，任务数：" << m_store.size()
+                       << "，快照版本号：" << m_snapshot.version().generation << "，数据库版本号：" << version.generation
+                       << "，属于同一数据库：" << (m_snapshot.version().databaseId == version.databaseId);
+        // 数据库标识不同（换用了另一个数据库文件）或版本号不同，快照都不能代表当前数据
+        if (m_snapshot.version() != version) {
+            reloadStoreInBackground();
+        }
+    } else {
+        // 没有可用快照（首次启动或文件损坏）：全量加载任务到内存，并在后台生成快照
+        m_store.load(m_sqlRepo->getAllTasks());
+        qCDebug(lcSql) << "内存任务库已加载，任务数：" << m_store.size();
+        onStoreModified();
+    }
+
+    // 启动提醒线程（按未完成任务的截止时间调度提醒）
+    m_reminderThread->setTasks(m_store.filter(-1, -1, 1));
     m_reminderThread->start();
     emit statusUpdated("提醒线程已启动");
 
-    // 初始加载所有未完成任务
-    auto tasks = getFilteredTasks(-1, -1, 1); // 1表示未完成
-    emit tasksChanged(tasks);
+    // 通知UI按筛选条件分页加载任务（不再一次性加载全部未完成任务）
+    emit tasksChanged();
 }
 
 QList<Category> TaskManager::getCategories()
+{
+    return m_categories.categories();
+}
+
+CategoryDictionary TaskManager::categoryDictionary() const
 {
     return m_categories;
 }
@@ -54,8 +116,8 @@ bool TaskManager::addCategory(const QString &categoryName)
     bool success = m_sqlRepo->addCategory(categoryName);
     if (success) {
         // 更新分类列表并发出信号
-        m_categories = m_sqlRepo->getAllCategories();
-        emit categoriesChanged(m_categories);
+        m_categories = CategoryDictionary(m_sqlRepo->getAllCategories());
+        emit categoriesChanged(m_categories.categories());
         emit statusUpdated(QString("成功添加分类：%1").arg(categoryName));
     } else {
         emit statusUpdated(QString("添加分类失败：%1").arg(categoryName));
@@ -68,10 +130,10 @@ bool TaskManager::deleteCategory(int categoryId)
     bool success = m_sqlRepo->deleteCategory(categoryId);
     if (success) {
         // 更新分类列表并发出信号
-        m_categories = m_sqlRepo->getAllCategories();
-        emit categoriesChanged(m_categories);
+        m_categories = CategoryDictionary(m_sqlRepo->getAllCategories());
+        emit categoriesChanged(m_categories.categories());
         // 重新加载任务（因为分类变化可能影响当前筛选结果）
-        emit tasksChanged(getFilteredTasks(-1, -1, -1));
+        emit tasksChanged();
         emit statusUpdated(QString("成功删除分类，ID：%1").arg(categoryId));
     } else {
         emit statusUpdated(QString("删除分类失败，ID：%1").arg(categoryId));
@@ -86,99 +148,483 @@ bool TaskManager::isCategoryUsed(int categoryId)
 
 bool TaskManager::addTask(const Task &task)
 {
-    bool success = m_sqlRepo->addTask(task);
+    Task added = task;
+    bool success = m_sqlRepo->addTask(task, &added.taskId);
+    applyTaskAdded(success, added);
+    return success;
+}
+
+bool TaskManager::editTask(const Task &task)
+{
+    bool success = m_sqlRepo->editTask(task);
+    applyTaskEdited(success, task);
+    return success;
+}
+
+bool TaskManager::deleteTask(int taskId)
+{
+    bool success = m_sqlRepo->deleteTask(taskId);
+    applyTaskDeleted(success, taskId);
+    return success;
+}
+
+bool TaskManager::markTaskCompleted(int taskId, bool isCompleted)
+{
+    bool success = m_sqlRepo->markTaskCompleted(taskId, isCompleted);
+    applyTaskCompleted(success, taskId, isCompleted);
+    return success;
+}
+
+void TaskManager::applyTaskAdded(bool success, const Task &task)
+{
     if (success) {
+        m_store.insert(task);
+        m_reminderThread->scheduleTask(task);
+        onStoreModified();
         emit statusUpdated("任务添加成功");
-        // 刷新任务列表
-        auto tasks = getFilteredTasks(-1, -1, 1); // 1表示未完成
-        emit tasksChanged(tasks);
+        // 通知UI插入一行（使用内存任务库中的版本，截止时间与数据库一致）
+        emit taskInserted(m_store.task(task.taskId));
     } else {
         emit statusUpdated("任务添加失败");
     }
-    return success;
 }
 
-bool TaskManager::editTask(const Task &task)
+void TaskManager::applyTaskEdited(bool success, const Task &task)
 {
-    bool success = m_sqlRepo->editTask(task);
     if (success) {
+        Task previous = m_store.task(task.taskId);
+        m_store.insert(task);
+        m_reminderThread->scheduleTask(task);
+        onStoreModified();
         emit statusUpdated("任务编辑成功");
-        auto tasks = getFilteredTasks(-1, -1, 1); // 1表示未完成
-        emit tasksChanged(tasks);
+        if (previous.taskId == -1) {
+            emit taskInserted(m_store.task(task.taskId));
+        } else {
+            emit taskUpdated(m_store.task(task.taskId), previous);
+        }
     } else {
         emit statusUpdated("任务编辑失败");
     }
-    return success;
 }
 
-bool TaskManager::deleteTask(int taskId)
+void TaskManager::applyTaskDeleted(bool success, int taskId)
 {
-    bool success = m_sqlRepo->deleteTask(taskId);
     if (success) {
+        Task removed = m_store.task(taskId);
+        m_store.remove(taskId);
+        m_reminderThread->unscheduleTask(taskId);
+        onStoreModified();
         emit statusUpdated("任务删除成功");
-        auto tasks = getFilteredTasks(-1, -1, 1); // 1表示未完成
-        emit tasksChanged(tasks);
+        if (removed.taskId != -1) {
+            emit taskRemoved(removed);
+        }
     } else {
         emit statusUpdated("任务删除失败");
     }
-    return success;
 }
 
-bool TaskManager::markTaskCompleted(int taskId, bool isCompleted)
+void TaskManager::applyTaskCompleted(bool success, int taskId, bool isCompleted)
 {
-    bool success = m_sqlRepo->markTaskCompleted(taskId, isCompleted);
     if (success) {
+        Task previous = m_store.task(taskId);
+        m_store.setCompleted(taskId, isCompleted);
+        m_reminderThread->scheduleTask(m_store.task(taskId));
+        onStoreModified();
         emit statusUpdated(isCompleted ? "任务标记为已完成" : "任务标记为未完成");
-        // 重新加载当前筛选条件的任务
-        auto tasks = getFilteredTasks(-1, -1, 1); // 1表示未完成
-        emit tasksChanged(tasks);
+        if (previous.taskId != -1) {
+            emit taskUpdated(m_store.task(taskId), previous);
+        }
     } else {
         emit statusUpdated("任务状态更新失败");
     }
+}
+
+QFuture<bool> TaskManager::addTaskAsync(const Task &task)
+{
+    ++m_pendingWrites;
+    quint64 epoch = m_restoreEpoch;
+    return QtConcurrent::run(&m_dbWorker, [this, task]() {
+        Task added = task;
+        if (!m_sqlRepo->addTask(task, &added.taskId)) {
+            added.taskId = -1;
+        }
+        return added;
+    }).then(this, [this, epoch](const Task &added) {
+        --m_pendingWrites;
+        if (epoch != m_restoreEpoch) {
+            return false; // 写入的是恢复前的数据库文件，已被整体替换
+        }
+        bool success = added.taskId != -1;
+        applyTaskAdded(success, added);
+        return success;
+    });
+}
+
+QFuture<bool> TaskManager::editTaskAsync(const Task &task)
+{
+    ++m_pendingWrites;
+    quint64 epoch = m_restoreEpoch;
+    return QtConcurrent::run(&m_dbWorker, [this, task]() {
+        return m_sqlRepo->editTask(task);
+    }).then(this, [this, epoch, task](bool success) {
+        --m_pendingWrites;
+        if (epoch != m_restoreEpoch) {
+            return false;
+        }
+        applyTaskEdited(success, task);
+        return success;
+    });
+}
+
+QFuture<bool> TaskManager::deleteTaskAsync(int taskId)
+{
+    ++m_pendingWrites;
+    quint64 epoch = m_restoreEpoch;
+    return QtConcurrent::run(&m_dbWorker, [this, taskId]() {
+        return m_sqlRepo->deleteTask(taskId);
+    }).then(this, [this, epoch, taskId](bool success) {
+        --m_pendingWrites;
+        if (epoch != m_restoreEpoch) {
+            return false;
+        }
+        applyTaskDeleted(success, taskId);
+        return success;
+    });
+}
+
+QFuture<bool> TaskManager::markTaskCompletedAsync(int taskId, bool isCompleted)
+{
+    ++m_pendingWrites;
+    quint64 epoch = m_restoreEpoch;
+    return QtConcurrent::run(&m_dbWorker, [this, taskId, isCompleted]() {
+        return m_sqlRepo->markTaskCompleted(taskId, isCompleted);
+    }).then(this, [this, epoch, taskId, isCompleted](bool success) {
+        --m_pendingWrites;
+        if (epoch != m_restoreEpoch) {
+            return false;
+        }
+        applyTaskCompleted(success, taskId, isCompleted);
+        return success;
+    });
+}
+
+QList<int> TaskManager::addTasks(const QList<Task> &tasks)
+{
+    QList<int> taskIds = m_sqlRepo->addTasks(tasks);
+    if (!taskIds.isEmpty()) {
+        for (int i = 0; i < taskIds.size(); ++i) {
+            Task added = tasks.at(i);
+            added.taskId = taskIds.at(i);
+            m_store.insert(added);
+            m_reminderThread->scheduleTask(added);
+        }
+        onStoreModified();
+        emit statusUpdated(QString("成功批量添加%1个任务").arg(taskIds.size()));
+        emit tasksChanged();
+    } else if (!tasks.isEmpty()) {
+        emit statusUpdated("批量添加任务失败");
+    }
+    return taskIds;
+}
+
+bool TaskManager::updateTasks(const QList<Task> &tasks)
+{
+    bool success = m_sqlRepo->updateTasks(tasks);
+    if (success) {
+        for (const Task &task : tasks) {
+            m_store.insert(task);
+            m_reminderThread->scheduleTask(task);
+        }
+        onStoreModified();
+        emit statusUpdated(QString("成功批量编辑%1个任务").arg(tasks.size()));
+        emit tasksChanged();
+    } else {
+        emit statusUpdated("批量编辑任务失败");
+    }
+    return success;
+}
+
+bool TaskManager::deleteTasks(const QList<int> &taskIds)
+{
+    bool success = m_sqlRepo->deleteTasks(taskIds);
+    if (success) {
+        for (int taskId : taskIds) {
+            m_store.remove(taskId);
+            m_reminderThread->unscheduleTask(taskId);
+        }
+        onStoreModified();
+        emit statusUpdated(QString("成功批量删除%1个任务").arg(taskIds.size()));
+        emit tasksChanged();
+    } else {
+        emit statusUpdated("批量删除任务失败");
+    }
+    return success;
+}
+
+bool TaskManager::setCompleted(const QList<int> &taskIds, bool isCompleted)
+{
+    bool success = m_sqlRepo->setCompleted(taskIds, isCompleted);
+    if (success) {
+        for (int taskId : taskIds) {
+            m_store.setCompleted(taskId, isCompleted);
+            m_reminderThread->scheduleTask(m_store.task(taskId));
+        }
+        onStoreModified();
+        emit statusUpdated(QString("成功将%1个任务标记为%2").arg(taskIds.size()).arg(isCompleted ? "已完成" : "未完成"));
+        emit tasksChanged();
+    } else {
+        emit statusUpdated("批量更新任务状态失败");
+    }
     return success;
 }
 
-QList<Task> TaskManager::getFilteredTasks(int priority, int categoryId, int completedFilter)
+QList<Task> TaskManager::getFilteredTasksPage(int priority, int categoryId, int completedFilter,
+                                              const TaskCursor &after, int limit)
+{
+    int storeCompletedFilter = completedFilter == 0 ? -1 : completedFilter;
+    return m_store.filterPage(priority, categoryId, storeCompletedFilter, after, limit);
+}
+
+QList<Task> TaskManager::getFilteredTasksPage(int priority, int categoryId, int completedFilter, const TaskOrder &order,
+                                              const Task *after, int limit)
+{
+    int storeCompletedFilter = completedFilter == 0 ? -1 : completedFilter;
+    return m_store.filterPage(priority, categoryId, storeCompletedFilter, order, after, limit);
+}
+
+int TaskManager::countFilteredTasks(int priority, int categoryId, int completedFilter)
+{
+    int storeCompletedFilter = completedFilter == 0 ? -1 : completedFilter;
+    return m_store.count(priority, categoryId, storeCompletedFilter);
+}
+
+bool TaskManager::matchesFilter(const Task &task, int priority, int categoryId, int completedFilter)
+{
+    return TaskStore::matches(task, priority, categoryId, completedFilter == 0 ? -1 : completedFilter);
+}
+
+QFuture<TaskSearchResult> TaskManager::searchTasksAsync(const QString &keyword)
+{
+    // 新的搜索取代旧搜索：未开始的不再执行，正在执行的语句被中断
+    m_pendingSearch.cancel();
+    m_sqlRepo->interruptSearch();
+
+    // 继续输入时新关键字包含旧关键字，匹配新关键字的任务一定在旧的完整结果中，无需查询数据库
+    if (m_lastSearch.complete && !m_lastSearch.keyword.isEmpty()
+        && keyword.contains(m_lastSearch.keyword, Qt::CaseInsensitive)) {
+        m_lastSearch = refineSearchResult(m_lastSearch, keyword);
+        qCDebug(lcSql) << "在上一次搜索结果中细化，关键字：" << keyword << "，结果数：" << m_lastSearch.tasks.size();
+        m_pendingSearch = QtFuture::makeReadyFuture(m_lastSearch);
+        return m_pendingSearch;
+    }
+
+    quint64 revision = m_storeRevision;
+    m_pendingSearch = QtConcurrent::run(&m_dbWorker, [this, keyword](QPromise<TaskSearchResult> &promise) {
+        TaskSearchResult result;
+        result.keyword = keyword;
+        result.tasks = m_sqlRepo->searchTasks(keyword, &result.snippets, [&promise]() {
+            return promise.isCanceled();
+        });
+        // 只有全文索引的结果可以细化：它与refineSearchResult一样按Unicode折叠大小写，
+        // 而LIKE只折叠ASCII字母，两者对非ASCII字母的匹配结果不同
+        result.complete = m_sqlRepo->usesFullTextIndex(keyword)
+            && result.tasks.size() < SqlRepository::kSearchResultLimit;
+        promise.addResult(result);
+    });
+    return m_pendingSearch.then(this, [this, revision](const TaskSearchResult &result) {
+        // 查询期间内存任务库有变化时结果可能已过时，不作为细化的基础
+        if (revision == m_storeRevision) {
+            m_lastSearch = result;
+        }
+        return result;
+    });
+}
+
+TaskSearchResult TaskManager::refineSearchResult(const TaskSearchResult &previous, const QString &keyword) const
+{
+    TaskSearchResult result;
+    result.keyword = keyword;
+    result.complete = true; // 完整结果的子集仍是完整结果
+    for (const Task &previousTask : previous.tasks) {
+        Task task = m_store.task(previousTask.taskId);
+        if (task.taskId == -1) {
+            continue;
+        }
+        // 与全文索引一致：标题或描述包含关键字（按Unicode不区分大小写），保持上一次结果的顺序
+        int pos = task.title.indexOf(keyword, 0, Qt::CaseInsensitive);
+        const QString *matched = &task.title;
+        if (pos == -1) {
+            pos = task.description.indexOf(keyword, 0, Qt::CaseInsensitive);
+            matched = &task.description;
+        }
+        if (pos == -1) {
+            continue;
+        }
+        result.snippets.insert(task.taskId, makeSnippet(*matched, pos, keyword.size()));
+        result.tasks.append(task);
+    }
+    return result;
+}
+
+QString TaskManager::makeSnippet(const QString &text, int matchPos, int matchLength)
+{
+    // 与数据库摘要格式一致：命中部分用【】标记，前后各保留少量上下文，截断处用…表示
+    const int context = 8;
+    int start = qMax(0, matchPos - context);
+    int end = qMin(text.size(), matchPos + matchLength + context);
+    return (start > 0 ? "…" : "") + text.mid(start, matchPos - start)
+           + "【" + text.mid(matchPos, matchLength) + "】"
+           + text.mid(matchPos + matchLength, end - matchPos - matchLength) + (end < text.size() ? "…" : "");
+}
+
+QFuture<TaskStatistics> TaskManager::getTaskStatisticsBreakdownAsync()
+{
+    m_pendingStatistics.cancel();
+    m_pendingStatistics = QtConcurrent::run(&m_dbWorker, [this]() {
+        return m_sqlRepo->getTaskStatisticsBreakdown();
+    });
+    return m_pendingStatistics;
+}
+
+bool TaskManager::exportFilteredTasksToCsv(const QString &filePath, int priority, int categoryId, int completedFilter)
 {
-    // 将completedFilter转换为sqlrepository所需的格式：
-    // 0=全部(-1), 1=未完成(1), 2=已完成(2)
+    if (m_exportThread) {
+        emit statusUpdated("已有报表正在导出");
+        return false;
+    }
+
+    // 导出在独立线程和连接上执行，读取的是开始导出时的数据库快照，界面可继续编辑任务
     int sqlCompletedFilter = completedFilter == 0 ? -1 : completedFilter;
-    
-    // 直接调用数据库层的筛选函数
-    return m_sqlRepo->getTasksByFilter(priority, categoryId, sqlCompletedFilter);
+    m_exportThread = new ExportThread(filePath, priority, categoryId, sqlCompletedFilter, m_categories, this);
+    connect(m_exportThread, &ExportThread::exportProgress, this, &TaskManager::exportProgress);
+    connect(m_exportThread, &ExportThread::exportFinished, this, [this](bool success, bool canceled, const QString &path) {
+        emit statusUpdated(canceled ? "报表导出已取消" : (success ? "报表导出成功" : "报表导出失败"));
+        emit exportFinished(success, canceled, path);
+    });
+    connect(m_exportThread, &QThread::finished, this, [this]() {
+        m_exportThread->deleteLater();
+        m_exportThread = nullptr;
+    });
+    m_exportThread->start();
+    emit statusUpdated("正在后台导出报表...");
+    return true;
 }
 
-QList<Task> TaskManager::searchTasks(const QString &keyword)
+void TaskManager::cancelExport()
 {
-    // 直接调用数据库层的搜索函数
-    return m_sqlRepo->searchTasks(keyword);
+    if (m_exportThread) {
+        m_exportThread->cancel();
+    }
 }
 
-bool TaskManager::exportTasksToCsv(const QString &filePath, const QList<Task> &tasks)
+QFuture<CsvImportResult> TaskManager::importTasksFromCsvAsync(const QString &filePath)
 {
-    bool success = m_fileExporter->exportToCsv(filePath, tasks, m_categories);
-    emit statusUpdated(success ? "报表导出成功" : "报表导出失败");
-    return success;
+    ++m_pendingWrites;
+    quint64 epoch = m_restoreEpoch;
+    // 写库成功的任务（带新ID），导入结束后在GUI线程一次性加入内存任务库
+    auto imported = std::make_shared<QList<Task>>();
+    CategoryDictionary categories = m_categories;
+    return QtConcurrent::run(&m_dbWorker, [this, filePath, categories, imported]() {
+        FileImporter importer;
+        return importer.importFromCsv(filePath, categories, [this, imported](const QList<Task> &tasks) {
+            QList<int> taskIds = m_sqlRepo->addTasks(tasks);
+            if (taskIds.isEmpty()) {
+                return false;
+            }
+            for (int i = 0; i < taskIds.size(); ++i) {
+                Task added = tasks.at(i);
+                added.taskId = taskIds.at(i);
+                imported->append(added);
+            }
+            return true;
+        }, [this](qint64 rowsImported, qint64, qint64) {
+            emit statusUpdated(QString("正在导入任务：已导入%1行").arg(rowsImported));
+            return true;
+        });
+    }).then(this, [this, epoch, imported](const CsvImportResult &result) {
+        --m_pendingWrites;
+        if (epoch != m_restoreEpoch) {
+            emit statusUpdated("数据库已恢复，导入的任务未保留");
+            CsvImportResult discarded = result;
+            discarded.success = false;
+            discarded.rowsImported = 0;
+            return discarded;
+        }
+        if (!imported->isEmpty()) {
+            for (const Task &task : std::as_const(*imported)) {
+                m_store.insert(task);
+            }
+            m_reminderThread->setTasks(m_store.filter(-1, -1, 1));
+            onStoreModified();
+            emit tasksChanged();
+        }
+        emit statusUpdated(result.success ? QString("成功导入%1个任务，跳过%2行").arg(result.rowsImported).arg(result.rowsRejected)
+                                          : QString("导入任务失败，已导入%1个任务").arg(result.rowsImported));
+        return result;
+    });
 }
 
 bool TaskManager::backupDatabase(const QString &backupPath)
 {
-    bool success = m_sqlRepo->backupDatabase(backupPath);
-    emit statusUpdated(success ? "数据库备份成功" : "数据库备份失败");
-    return success;
+    if (m_backupThread) {
+        emit statusUpdated("已有数据库备份正在进行");
+        return false;
+    }
+
+    // 备份在独立线程和连接上执行，界面可继续编辑任务
+    m_backupThread = new BackupThread(backupPath, this);
+    connect(m_backupThread, &BackupThread::backupProgress, this, &TaskManager::backupProgress);
+    connect(m_backupThread, &BackupThread::backupFinished, this, [this](bool success, bool canceled, const QString &path) {
+        emit statusUpdated(canceled ? "数据库备份已取消" : (success ? "数据库备份成功" : "数据库备份失败"));
+        emit backupFinished(success, canceled, path);
+    });
+    connect(m_backupThread, &QThread::finished, this, [this]() {
+        m_backupThread->deleteLater();
+        m_backupThread = nullptr;
+    });
+    m_backupThread->start();
+    emit statusUpdated("正在后台备份数据库...");
+    return true;
+}
+
+void TaskManager::cancelBackup()
+{
+    if (m_backupThread) {
+        m_backupThread->cancel();
+    }
 }
 
 bool TaskManager::restoreDatabase(const QString &backupPath)
 {
+    // 恢复需要替换数据库文件，不能与备份、导出同时进行
+    if (m_backupThread) {
+        emit statusUpdated("数据库备份正在进行，请稍后再恢复");
+        return false;
+    }
+    if (m_exportThread) {
+        emit statusUpdated("报表正在导出，请稍后再恢复");
+        return false;
+    }
+
+    // 等待工作线程上已排队的操作完成，并关闭其连接，避免恢复时仍占用旧数据库文件
+    QtConcurrent::run(&m_dbWorker, [this]() {
+        m_sqlRepo->releaseThreadConnection();
+    }).waitForFinished();
+
     bool success = m_sqlRepo->restoreDatabase(backupPath);
     if (success) {
+        // 已执行完的异步写入作用于旧数据库，其排队中的后续处理不能再应用到重新加载的内存任务库
+        ++m_restoreEpoch;
+        // 数据库整体被替换，重新全量加载内存任务库
+        m_store.load(m_sqlRepo->getAllTasks());
+        m_reminderThread->setTasks(m_store.filter(-1, -1, 1));
+        onStoreModified();
         // 恢复成功后重新加载数据
-        m_categories = m_sqlRepo->getAllCategories();
-        emit categoriesChanged(m_categories);
+        m_categories = CategoryDictionary(m_sqlRepo->getAllCategories());
+        emit categoriesChanged(m_categories.categories());
         
         // 重新加载任务
-        QList<Task> tasks = m_sqlRepo->getAllTasks();
-        emit tasksChanged(tasks);
+        emit tasksChanged();
         
         emit statusUpdated("数据库恢复成功，数据已重新加载");
     } else {
@@ -192,6 +638,11 @@ void TaskManager::getTaskStatistics(int &totalTasks, int &completedTasks)
     m_sqlRepo->getTaskStatistics(totalTasks, completedTasks);
 }
 
+TaskStatistics TaskManager::getTaskStatisticsBreakdown()
+{
+    return m_sqlRepo->getTaskStatisticsBreakdown();
+}
+
 void TaskManager::onThreadReminder(const QList<Task> &tasks)
 {
     // 转发每个任务的提醒信号（UI接收后弹出对话框）
@@ -200,18 +651,64 @@ void TaskManager::onThreadReminder(const QList<Task> &tasks)
     }
 }
 
-Task TaskManager::getTaskById(int taskId)
+QString TaskManager::snapshotBasePath() const
 {
-    // 1. 从数据库中查询指定ID的任务
-    QList<Task> allTasks = m_repo.getAllTasks(); // m_repo是引用，使用.运算符
-    for (const Task &task : allTasks) {
-        if (task.taskId == taskId) {
-            return task; // 找到匹配ID的任务，返回
+    return m_sqlRepo->getDatabasePath() + ".snapshot";
+}
+
+void TaskManager::onStoreModified()
+{
+    ++m_storeRevision;
+    m_lastSearch = TaskSearchResult(); // 任务有增删改，旧的搜索结果不能再作为细化的基础
+    m_snapshotTimer->start();
+}
+
+void TaskManager::reloadStoreInBackground()
+{
+    // 重新加载期间视为一次未完成的写入，暂停写快照
+    ++m_pendingWrites;
+    quint64 revision = m_storeRevision;
+    QtConcurrent::run(&m_dbWorker, [this]() {
+        return m_sqlRepo->getAllTasks();
+    }).then(this, [this, revision](const QList<Task> &tasks) {
+        --m_pendingWrites;
+        if (revision != m_storeRevision) {
+            // 读取期间内存任务库被同步接口修改过，读到的结果可能早于该修改，重新加载
+            reloadStoreInBackground();
+            return;
         }
+        m_store.load(tasks);
+        m_reminderThread->setTasks(m_store.filter(-1, -1, 1));
+        onStoreModified();
+        qCDebug(lcSql) << "内存任务库已与数据库同步，任务数：" << m_store.size();
+        emit tasksChanged();
+    });
+}
+
+void TaskManager::writeSnapshot()
+{
+    // 有未应用的异步写入或上一次快照仍在写入时稍后重试，保证快照内容与记录的版本号一致
+    if (m_pendingWrites > 0 || m_snapshotWrite.isRunning()) {
+        m_snapshotTimer->start();
+        return;
     }
+    // 此时所有写入都已应用到内存任务库，数据库版本号即对应当前内存内容
+    DataVersion version = m_sqlRepo->dataVersion();
+    if (!version.isValid()) {
+        return;
+    }
+    QString filePath = m_snapshot.nextWritePath(snapshotBasePath());
+    // 隐式共享内存任务库的主存储，GUI线程上不复制任务，序列化全部在后台线程进行；
+    // 写入期间若又有修改，由TaskStore在修改时分离副本，后台线程读到的仍是提交快照时的内容
+    QHash<int, Task> tasks = m_store.tasks();
+    quint64 sequence = m_snapshot.takeNextSequence();
+    m_snapshotWrite = QtConcurrent::run([filePath, tasks, version, sequence]() {
+        TaskSnapshot::write(filePath, tasks, version, sequence);
+    });
+}
 
-    // 2. 若未找到，返回空任务（taskId=-1标识无效）
-    Task emptyTask;
-    emptyTask.taskId = -1;
-    return emptyTask;
+Task TaskManager::getTaskById(int taskId)
+{
+    // 内存任务库包含全部任务，未找到时taskId为-1
+    return m_store.task(taskId);
 }
@@ -3,10 +3,27 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QFuture>
+#include <QThreadPool>
 #include "sqlrepository.h"
+#include "taskstore.h"
+#include "tasksnapshot.h"
+#include "fileimporter.h"
+#include "categorydictionary.h"
 
 class ReminderThread;
-class FileExporter;
+class BackupThread;
+class ExportThread;
+class QTimer;
+
+// 异步搜索结果（任务按相关度排序，snippets为任务ID->高亮摘要）
+struct TaskSearchResult {
+    QString keyword;               // 本次搜索的关键字
+    QList<Task> tasks;
+    QHash<int, QString> snippets;
+    bool complete = false;         // 全文索引的结果且未被条数上限截断（可在内存中进一步细化）
+};
 
 class TaskManager : public QObject
 {
@@ -15,11 +32,12 @@ public:
     explicit TaskManager(QObject *parent = nullptr);
     ~TaskManager();
 
-    // 初始化（启动线程、加载分类）
+    // 初始化（启动线程、加载分类和任务）
     void init();
 
     // 分类相关接口
     QList<Category> getCategories();
+    CategoryDictionary categoryDictionary() const; // 当前分类字典（分类变化时重建）
     bool addCategory(const QString &categoryName); // 添加分类
     bool deleteCategory(int categoryId); // 删除分类
     bool isCategoryUsed(int categoryId); // 检查分类是否被任务使用
@@ -29,42 +47,113 @@ public:
     bool editTask(const Task &task);
     bool deleteTask(int taskId);
     bool markTaskCompleted(int taskId, bool isCompleted);
-    QList<Task> getFilteredTasks(int priority, int categoryId, int completedFilter);
-    QList<Task> searchTasks(const QString &keyword); // 按标题或描述模糊搜索任务
+    // 批量任务接口（单事务写入，完成后只发出一次tasksChanged）
+    QList<int> addTasks(const QList<Task> &tasks); // 返回新任务ID，失败返回空列表
+    bool updateTasks(const QList<Task> &tasks);
+    bool deleteTasks(const QList<int> &taskIds);
+    bool setCompleted(const QList<int> &taskIds, bool isCompleted);
+    // 分页获取筛选结果（-1表示不筛选；completedFilter：0=全部，1=未完成，2=已完成）
+    QList<Task> getFilteredTasksPage(int priority, int categoryId, int completedFilter, const TaskCursor &after, int limit);
+    // 按指定排序方式分页：返回排在after之后的最多limit条任务（after为nullptr时从第一条开始），
+    // 由内存任务库的有序索引直接给出，切换排序不需要重新排序
+    QList<Task> getFilteredTasksPage(int priority, int categoryId, int completedFilter, const TaskOrder &order,
+                                     const Task *after, int limit);
+    int countFilteredTasks(int priority, int categoryId, int completedFilter); // 筛选结果总数
+    // 判断任务是否满足筛选条件（completedFilter含义同getFilteredTasksPage），供模型处理增量更新
+    static bool matchesFilter(const Task &task, int priority, int categoryId, int completedFilter);
+
+    // 异步接口：在数据库工作线程上按提交顺序执行，GUI线程不等待SQLite
+    // 写操作完成后在GUI线程同步内存任务库并发出与同步接口相同的信号
+    QFuture<bool> addTaskAsync(const Task &task);
+    QFuture<bool> editTaskAsync(const Task &task);
+    QFuture<bool> deleteTaskAsync(int taskId);
+    QFuture<bool> markTaskCompletedAsync(int taskId, bool isCompleted);
+    // 异步读取：提交同类新请求时，尚未开始执行的旧请求会被取消
+    // 搜索：新关键字包含上一次完整结果的关键字时（如继续输入），直接在上一次结果中筛选并立即返回；
+    // 否则在数据库工作线程查询，被新的搜索取代时中断查询
+    QFuture<TaskSearchResult> searchTasksAsync(const QString &keyword);
+    QFuture<TaskStatistics> getTaskStatisticsBreakdownAsync();
 
     // 报表导出接口
-    bool exportTasksToCsv(const QString &filePath, const QList<Task> &tasks);
+    // 后台导出筛选结果（completedFilter含义同getFilteredTasksPage）：独立线程和连接，在一个读事务内流式写入，
+    // 返回是否成功启动（进度由exportProgress通知，结果由exportFinished通知）
+    bool exportFilteredTasksToCsv(const QString &filePath, int priority, int categoryId, int completedFilter);
+    void cancelExport(); // 取消进行中的导出（部分文件会被删除）
+    // 在数据库工作线程上从CSV文件导入任务（格式同导出报表，支持GBK和UTF-8），
+    // 按大批次单事务写入，完成后同步内存任务库并发出tasksChanged
+    QFuture<CsvImportResult> importTasksFromCsvAsync(const QString &filePath);
     
     // 数据库备份/恢复接口
-    bool backupDatabase(const QString &backupPath); // 备份数据库
+    bool backupDatabase(const QString &backupPath); // 后台在线备份数据库，返回是否成功启动（结果由backupFinished通知）
+    void cancelBackup(); // 取消进行中的备份（已有的备份文件保持不变）
     bool restoreDatabase(const QString &backupPath); // 恢复数据库
     
     // 统计接口
     void getTaskStatistics(int &totalTasks, int &completedTasks); // 获取任务完成统计
+    TaskStatistics getTaskStatisticsBreakdown(); // 获取按分类、优先级划分的统计（含逾期数）
 
     // 新增：声明getTaskById函数
     Task getTaskById(int taskId); // 根据ID获取单个任务
 
 signals:
-    // 任务数据变化信号（通知UI刷新）
-    void tasksChanged(const QList<Task> &tasks);
+    // 任务数据整体变化信号（批量操作、恢复数据库后通知UI按当前筛选条件分页重新加载）
+    void tasksChanged();
+    // 单个任务的增量变化信号（UI据此逐行更新，无需重置模型）
+    void taskInserted(const Task &task);
+    void taskUpdated(const Task &task, const Task &previous); // previous为修改前的任务
+    void taskRemoved(const Task &task);
     // 分类数据变化信号（通知UI刷新分类列表）
     void categoriesChanged(const QList<Category> &categories);
     // 提醒信号（转发线程的提醒）
     void taskReminder(const Task &task);
     // 状态通知信号（用于状态栏提示）
     void statusUpdated(const QString &status);
+    // 后台备份进度与结果
+    void backupProgress(qint64 bytesWritten, qint64 bytesTotal);
+    void backupFinished(bool success, bool canceled, const QString &backupPath);
+    // 后台导出进度与结果
+    void exportProgress(qint64 rowsWritten, qint64 rowsTotal, qint64 bytesWritten);
+    void exportFinished(bool success, bool canceled, const QString &filePath);
 
 private slots:
     // 接收线程的提醒任务信号
     void onThreadReminder(const QList<Task> &tasks);
 
 private:
+    // 写库完成后的公共处理（同步内存任务库、发出状态和变化信号），同步与异步接口共用
+    void applyTaskAdded(bool success, const Task &task);
+    void applyTaskEdited(bool success, const Task &task);
+    void applyTaskDeleted(bool success, int taskId);
+    void applyTaskCompleted(bool success, int taskId, bool isCompleted);
+
+    // 任务快照：内存任务库变化后延迟在后台写入，启动时用于快速加载
+    static constexpr int kSnapshotDelayMs = 2000;
+    QString snapshotBasePath() const;
+    void onStoreModified();         // 内存任务库每次变化后调用
+    void reloadStoreInBackground(); // 快照过期时在工作线程从SQLite重新加载
+    void writeSnapshot();
+
+    // 在上一次搜索结果中筛选出同时匹配新关键字的任务（任务内容从内存任务库重新读取），并生成高亮摘要
+    TaskSearchResult refineSearchResult(const TaskSearchResult &previous, const QString &keyword) const;
+    static QString makeSnippet(const QString &text, int matchPos, int matchLength);
+
     SqlRepository &m_repo;
     SqlRepository *m_sqlRepo;       // 数据库操作实例
     ReminderThread *m_reminderThread; // 提醒线程实例
-    FileExporter *m_fileExporter;   // 文件导出实例
-    QList<Category> m_categories;   // 缓存分类列表
+    BackupThread *m_backupThread = nullptr; // 正在进行的备份线程（无备份时为空）
+    ExportThread *m_exportThread = nullptr; // 正在进行的导出线程（无导出时为空）
+    CategoryDictionary m_categories; // 缓存分类字典（分类变化时重建）
+    QThreadPool m_dbWorker;         // 数据库工作线程（单线程，任务按提交顺序执行，独占该线程的数据库连接）
+    QFuture<TaskStatistics> m_pendingStatistics; // 最近一次异步统计
+    TaskSnapshot m_snapshot;        // 任务快照（启动时读取，之后记录写入的槽位和序号）
+    QFuture<TaskSearchResult> m_pendingSearch;   // 最近一次异步搜索（数据库查询）
+    TaskSearchResult m_lastSearch;               // 最近一次完成的搜索结果（内存任务库变化后失效）
+    QTimer *m_snapshotTimer;        // 延迟写入快照的定时器（运行中表示有未写入的变化）
+    QFuture<void> m_snapshotWrite;  // 进行中的快照写入
+    int m_pendingWrites = 0;        // 已提交但尚未应用到内存任务库的异步写入数
+    quint64 m_storeRevision = 0;    // 内存任务库修改计数
+    quint64 m_restoreEpoch = 0;     // 数据库恢复次数：恢复前提交的异步写入完成后不再应用到内存任务库
+    TaskStore m_store;              // 内存任务库：启动时全量加载，写库成功后同步更新，筛选与按ID查询直接读内存
 };
 
 #endif // TASKMANAGER_H
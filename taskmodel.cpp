@@ -1,18 +1,346 @@
 #include "taskmodel.h"
 #include <QColor>
+#include <algorithm>
+
+namespace {
+
+// 固定的显示文本，data()直接返回共享的字符串
+const QString &priorityText(int priority)
+{
+    static const QString low = "低", medium = "中", high = "高";
+    return priority == 1 ? low : (priority == 2 ? medium : high);
+}
+
+const QString &completedText(bool isCompleted)
+{
+    static const QString done = "✓", pending = "✗";
+    return isCompleted ? done : pending;
+}
+
+const QString &emptyDescriptionText()
+{
+    static const QString text = "无";
+    return text;
+}
+
+// QTimer间隔为int毫秒，更远的截止时间分段等待
+constexpr qint64 kMaxOverdueTimerMs = 24 * 60 * 60 * 1000;
+
+} // namespace
 
 TaskModel::TaskModel(QObject *parent) : QAbstractTableModel(parent)
 {
+    m_overdueTimer = new QTimer(this);
+    m_overdueTimer->setSingleShot(true);
+    m_overdueTimer->setTimerType(Qt::PreciseTimer); // 截止时间到达时准时标红
+    connect(m_overdueTimer, &QTimer::timeout, this, &TaskModel::onOverdueTimeout);
 }
 
-void TaskModel::setTasks(const QList<Task> &tasks, const QList<Category> &categories)
+void TaskModel::setTasks(const QList<Task> &tasks, const CategoryDictionary &categories,
+                         const QHash<int, QString> &snippets)
 {
     beginResetModel(); // 开始重置模型（通知View数据即将变化）
     m_tasks = tasks;
     m_categories = categories;
+    m_order = TaskOrder(m_order.key(), m_order.order(), categories);
+    if (!m_order.isDefault()) {
+        // 搜索结果默认按相关度排列，用户选择了其他排序时在内存中排序（条数有上限）
+        std::stable_sort(m_tasks.begin(), m_tasks.end(), m_order);
+    }
+    m_snippets = snippets;
+    m_pageFetcher = nullptr;
+    m_rowFilter = nullptr;
+    m_hasMore = false;
+    rebuildRowCache();
     endResetModel(); // 结束重置（View自动刷新）
 }
 
+void TaskModel::setPageFetcher(const PageFetcher &fetcher, const RowFilter &filter, const CategoryDictionary &categories)
+{
+    beginResetModel();
+    m_pageFetcher = fetcher;
+    m_rowFilter = filter;
+    m_categories = categories;
+    m_order = TaskOrder(m_order.key(), m_order.order(), categories);
+    m_snippets.clear();
+    // 只取第一页，保证首屏立即显示
+    m_tasks = m_pageFetcher ? m_pageFetcher(m_order, nullptr, kPageSize) : QList<Task>();
+    m_hasMore = m_tasks.size() == kPageSize;
+    rebuildRowCache();
+    endResetModel();
+}
+
+bool TaskModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_hasMore;
+}
+
+void TaskModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || !m_hasMore || !m_pageFetcher) {
+        return;
+    }
+
+    // 以已加载的最后一行作为游标继续读取下一页
+    QList<Task> page = m_pageFetcher(m_order, m_tasks.isEmpty() ? nullptr : &m_tasks.last(), kPageSize);
+    m_hasMore = page.size() == kPageSize;
+    if (page.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_tasks.size(), m_tasks.size() + page.size() - 1);
+    m_tasks.append(page);
+    appendRowCache(page);
+    endInsertRows();
+}
+
+void TaskModel::insertTask(const Task &task)
+{
+    // 搜索结果按相关度排列，不接收新任务
+    if (!m_pageFetcher || (m_rowFilter && !m_rowFilter(task)) || !isWithinLoaded(task)) {
+        return;
+    }
+
+    int row = sortedPosition(task);
+    beginInsertRows(QModelIndex(), row, row);
+    m_tasks.insert(row, task);
+    insertRowCache(row);
+    endInsertRows();
+}
+
+void TaskModel::updateTask(const Task &task, const Task &previous)
+{
+    int row = rowOf(previous);
+    if (row == -1) {
+        // 修改前不在列表中，修改后可能进入当前筛选范围
+        insertTask(task);
+        return;
+    }
+
+    // 搜索结果中的任务修改后仍保留；分页模式下需重新判断筛选条件和加载范围
+    bool stillVisible = !m_pageFetcher
+        || ((!m_rowFilter || m_rowFilter(task)) && isWithinLoaded(task));
+    if (!stillVisible) {
+        beginRemoveRows(QModelIndex(), row, row);
+        removeRowCache(row);
+        m_tasks.removeAt(row);
+        endRemoveRows();
+        return;
+    }
+
+    // 排序键变化时移动到新位置（搜索结果保持原有顺序）
+    int target = m_pageFetcher ? sortedPosition(task) : row;
+    if (target != row && target != row + 1) {
+        // beginMoveRows的目标行按移动前的行号计算
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), target);
+        int newRow = target > row ? target - 1 : target;
+        m_tasks.move(row, newRow);
+        moveRowCache(row, newRow);
+        endMoveRows();
+        row = newRow;
+    }
+    updateRowCache(row, task);
+    emit dataChanged(index(row, 0), index(row, Column_Count - 1));
+}
+
+void TaskModel::removeTask(const Task &task)
+{
+    int row = rowOf(task);
+    if (row == -1) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    removeRowCache(row);
+    m_tasks.removeAt(row);
+    endRemoveRows();
+}
+
+int TaskModel::sortedPosition(const Task &task) const
+{
+    auto it = std::lower_bound(m_tasks.cbegin(), m_tasks.cend(), task, m_order);
+    return int(it - m_tasks.cbegin());
+}
+
+int TaskModel::rowOf(const Task &task) const
+{
+    if (m_pageFetcher) {
+        int row = sortedPosition(task);
+        return row < m_tasks.size() && m_tasks.at(row).taskId == task.taskId ? row : -1;
+    }
+    // 搜索结果按相关度排列且条数有上限，直接顺序查找
+    for (int row = 0; row < m_tasks.size(); ++row) {
+        if (m_tasks.at(row).taskId == task.taskId) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+bool TaskModel::isWithinLoaded(const Task &task) const
+{
+    // 数据源已全部加载时任何位置都有效；否则只接受不晚于最后一行的任务
+    return !m_hasMore || (!m_tasks.isEmpty() && !m_order.lessThan(m_tasks.last(), task));
+}
+
+TaskModel::RowDisplay TaskModel::makeRowDisplay(const Task &task, qint64 nowMs)
+{
+    // 未完成且尚未到期的任务登记到待逾期集合，由定时器在截止时间到达时标红
+    const qint64 deadlineMs = task.deadline.toMSecsSinceEpoch();
+    bool overdue = !task.isCompleted && deadlineMs < nowMs;
+    if (!task.isCompleted && !overdue) {
+        m_pendingDeadlines.emplace(std::make_pair(deadlineMs, task.taskId), task);
+    }
+    return RowDisplay{task.deadline.toString("yyyy-MM-dd HH:mm"), m_categories.name(task.categoryId, "未知分类"), overdue};
+}
+
+void TaskModel::rebuildRowCache()
+{
+    m_rowDisplay.clear();
+    m_pendingDeadlines.clear();
+    appendRowCache(m_tasks);
+}
+
+void TaskModel::appendRowCache(const QList<Task> &tasks)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_rowDisplay.reserve(m_rowDisplay.size() + tasks.size());
+    for (const Task &task : tasks) {
+        m_rowDisplay.append(makeRowDisplay(task, now));
+    }
+    armOverdueTimer();
+}
+
+void TaskModel::insertRowCache(int row)
+{
+    m_rowDisplay.insert(row, makeRowDisplay(m_tasks.at(row), QDateTime::currentMSecsSinceEpoch()));
+    armOverdueTimer();
+}
+
+void TaskModel::removeRowCache(int row)
+{
+    // 在m_tasks删除该行之前调用，按其截止时间移出待逾期集合
+    forgetDeadline(m_tasks.at(row));
+    m_rowDisplay.removeAt(row);
+    armOverdueTimer();
+}
+
+void TaskModel::moveRowCache(int from, int to)
+{
+    m_rowDisplay.move(from, to);
+}
+
+void TaskModel::updateRowCache(int row, const Task &task)
+{
+    forgetDeadline(m_tasks.at(row));
+    m_tasks[row] = task;
+    m_rowDisplay[row] = makeRowDisplay(task, QDateTime::currentMSecsSinceEpoch());
+    armOverdueTimer();
+}
+
+void TaskModel::forgetDeadline(const Task &task)
+{
+    m_pendingDeadlines.erase({task.deadline.toMSecsSinceEpoch(), task.taskId});
+}
+
+void TaskModel::armOverdueTimer()
+{
+    if (m_pendingDeadlines.empty()) {
+        m_overdueTimer->stop();
+        m_armedDeadline = -1;
+        return;
+    }
+    // 最近的截止时间未变化时保留已启动的定时器
+    qint64 next = m_pendingDeadlines.begin()->first.first;
+    if (next == m_armedDeadline && m_overdueTimer->isActive()) {
+        return;
+    }
+    m_armedDeadline = next;
+    // 逾期判定为截止时间 < 当前时间，在截止时间之后1毫秒触发
+    qint64 delay = next + 1 - QDateTime::currentMSecsSinceEpoch();
+    m_overdueTimer->start(int(qBound<qint64>(0, delay, kMaxOverdueTimerMs)));
+}
+
+void TaskModel::onOverdueTimeout()
+{
+    // 只处理已到期的集合头部，每个到期任务按排序二分定位所在行
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    while (!m_pendingDeadlines.empty() && m_pendingDeadlines.begin()->first.first < now) {
+        auto it = m_pendingDeadlines.begin();
+        int row = rowOf(it->second);
+        m_pendingDeadlines.erase(it);
+        if (row != -1) {
+            m_rowDisplay[row].overdue = true;
+            emit dataChanged(index(row, 0), index(row, Column_Count - 1), {Qt::ForegroundRole});
+        }
+    }
+    m_armedDeadline = -1; // 分段等待的定时器到时后需按同一截止时间重新启动
+    armOverdueTimer();
+}
+
+void TaskModel::sort(int column, Qt::SortOrder order)
+{
+    TaskOrder::Key key;
+    switch (column) {
+    case Column_Title:
+        key = TaskOrder::ByTitle;
+        break;
+    case Column_Deadline:
+        key = TaskOrder::ByDeadline;
+        break;
+    case Column_Priority:
+        key = TaskOrder::ByPriority;
+        break;
+    case Column_Category:
+        key = TaskOrder::ByCategory;
+        break;
+    case Column_Completed:
+        key = TaskOrder::ByCompleted;
+        break;
+    default:
+        return; // 描述列不支持排序
+    }
+    if (key == m_order.key() && order == m_order.order()) {
+        return;
+    }
+
+    beginResetModel();
+    m_order = TaskOrder(key, order, m_categories);
+    if (m_pageFetcher) {
+        m_tasks = m_pageFetcher(m_order, nullptr, kPageSize);
+        m_hasMore = m_tasks.size() == kPageSize;
+    } else {
+        std::stable_sort(m_tasks.begin(), m_tasks.end(), m_order);
+    }
+    rebuildRowCache();
+    endResetModel();
+}
+
+bool TaskModel::isSortableColumn(int column)
+{
+    return column >= 0 && column < Column_Count && column != Column_Description;
+}
+
+int TaskModel::sortColumn() const
+{
+    switch (m_order.key()) {
+    case TaskOrder::ByTitle:
+        return Column_Title;
+    case TaskOrder::ByPriority:
+        return Column_Priority;
+    case TaskOrder::ByCategory:
+        return Column_Category;
+    case TaskOrder::ByCompleted:
+        return Column_Completed;
+    default:
+        return Column_Deadline;
+    }
+}
+
+Qt::SortOrder TaskModel::sortOrder() const
+{
+    return m_order.order();
+}
+
 int TaskModel::getTaskId(int row) const
 {
     if (row >= 0 && row < m_tasks.size()) {
@@ -45,29 +373,36 @@ QVariant TaskModel::data(const QModelIndex &index, int role) const
         case Column_Title:
             return task.title;
         case Column_Description:
-            return task.description.isEmpty() ? "无" : task.description;
+            // 搜索结果显示命中位置的高亮摘要
+            if (!m_snippets.isEmpty()) {
+                auto it = m_snippets.constFind(task.taskId);
+                if (it != m_snippets.constEnd() && !it.value().isEmpty()) {
+                    return it.value();
+                }
+            }
+            return task.description.isEmpty() ? emptyDescriptionText() : task.description;
         case Column_Deadline:
-            return task.deadline.toString("yyyy-MM-dd HH:mm");
+            return m_rowDisplay.at(index.row()).deadline;
         case Column_Priority:
-            return task.priority == 1 ? "低" : (task.priority == 2 ? "中" : "高");
+            return priorityText(task.priority);
         case Column_Category:
-            foreach (const Category &cat, m_categories) {
-                if (cat.categoryId == task.categoryId) {
-                    return cat.categoryName;
-                }
-            }
-            return "未知分类";
+            return m_rowDisplay.at(index.row()).category;
         case Column_Completed:
-            return task.isCompleted ? "✓" : "✗";
+            return completedText(task.isCompleted);
         default:
             return QVariant();
         }
+    } else if (role == Qt::ToolTipRole) {
+        // 描述列显示摘要时，悬停可查看完整描述
+        if (index.column() == Column_Description && m_snippets.contains(task.taskId)) {
+            return task.description;
+        }
     } else if (role == Qt::TextAlignmentRole) {
         // 文本居中对齐
         return Qt::AlignCenter;
     } else if (role == Qt::ForegroundRole) {
-        // 未完成且已超时的任务，文字标红
-        if (!task.isCompleted && task.deadline < QDateTime::currentDateTime()) {
+        // 未完成且已超时的任务，文字标红（逾期标记由定时器在截止时间到达时更新）
+        if (m_rowDisplay.at(index.row()).overdue) {
             return QColor(Qt::red);
         }
     }
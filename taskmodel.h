@@ -3,7 +3,13 @@
 
 #include <QAbstractTableModel>
 #include <QList>
+#include <QHash>
+#include <QTimer>
+#include <functional>
+#include <map>
 #include "sqlrepository.h"
+#include "categorydictionary.h"
+#include "taskorder.h"
 
 class TaskModel : public QAbstractTableModel
 {
@@ -20,12 +26,30 @@ public:
         Column_Count       // 列数
     };
 
+    // 分页数据源：返回按order排在after之后的最多limit条任务（after为nullptr时从第一条开始）
+    using PageFetcher = std::function<QList<Task>(const TaskOrder &order, const Task *after, int limit)>;
+    // 当前筛选条件：判断任务是否应显示在列表中（用于处理增量更新）
+    using RowFilter = std::function<bool(const Task &task)>;
+
     explicit TaskModel(QObject *parent = nullptr);
 
-    // 设置任务数据（刷新模型）
-    void setTasks(const QList<Task> &tasks, const QList<Category> &categories);
+    // 设置任务数据（刷新模型），snippets为搜索结果的任务ID->高亮摘要，显示在描述列
+    void setTasks(const QList<Task> &tasks, const CategoryDictionary &categories,
+                  const QHash<int, QString> &snippets = QHash<int, QString>());
+    // 设置分页数据源（刷新模型，只加载第一页，其余页在滚动时由View触发fetchMore加载）
+    void setPageFetcher(const PageFetcher &fetcher, const RowFilter &filter, const CategoryDictionary &categories);
+
+    // 增量更新：分页模式下行按当前排序方式有序，二分定位后逐行插入/修改/移动/删除，
+    // 不重置模型，保留View的选中和滚动位置；不满足当前筛选条件的任务会被忽略或移出
+    void insertTask(const Task &task);
+    void updateTask(const Task &task, const Task &previous);
+    void removeTask(const Task &task);
     // 获取指定行的任务ID
     int getTaskId(int row) const;
+    // 当前排序列和顺序（描述列不支持排序）
+    static bool isSortableColumn(int column);
+    int sortColumn() const;
+    Qt::SortOrder sortOrder() const;
 
     // QAbstractTableModel 纯虚函数重写
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -33,10 +57,53 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    // 表头排序：分页模式下按新排序方式重新读取第一页（排序由数据源的有序索引完成），搜索结果在内存中排序
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
 
 private:
-    QList<Task> m_tasks;         // 任务数据列表
-    QList<Category> m_categories;// 分类列表
+    static constexpr int kPageSize = 200; // 每页加载的任务数
+
+    // 分页模式下按当前排序方式的插入位置
+    int sortedPosition(const Task &task) const;
+    // 查找任务所在行（未加载时返回-1）
+    int rowOf(const Task &task) const;
+    // 任务是否落在已加载的范围内（范围之外的任务由后续fetchMore读取）
+    bool isWithinLoaded(const Task &task) const;
+
+    // 显示缓存：每行的格式化文本和逾期标记在数据设置时预先计算，与m_tasks逐行对应，
+    // data()只做查表，滚动时不格式化字符串也不读取时钟
+    struct RowDisplay {
+        QString deadline;     // 格式化后的截止时间
+        QString category;     // 分类名称
+        bool overdue = false; // 是否逾期（文字标红）
+    };
+    // 生成一行的缓存，尚未逾期的未完成任务同时登记到m_pendingDeadlines
+    RowDisplay makeRowDisplay(const Task &task, qint64 nowMs);
+    void rebuildRowCache();                    // 重建全部行的缓存（模型重置时）
+    void appendRowCache(const QList<Task> &tasks); // 为追加的行建立缓存
+    void insertRowCache(int row);              // 为m_tasks中新插入的行建立缓存
+    void removeRowCache(int row);              // 在m_tasks删除该行之前调用
+    void moveRowCache(int from, int to);
+    void updateRowCache(int row, const Task &task); // 以新内容替换该行任务并刷新缓存
+    void forgetDeadline(const Task &task);     // 从待逾期集合中移除任务
+    // 逾期定时器：只在最近一个尚未逾期的截止时间到达时触发；最近截止时间不变时不重新启动
+    void armOverdueTimer();
+    void onOverdueTimeout();
+
+    QList<Task> m_tasks;         // 已加载的任务数据列表
+    PageFetcher m_pageFetcher;   // 分页数据源（为空表示一次性设置的完整列表）
+    RowFilter m_rowFilter;       // 分页数据源对应的筛选条件
+    TaskOrder m_order;           // 当前排序方式（默认截止时间升序）
+    bool m_hasMore = false;      // 数据源是否还有未加载的任务
+    CategoryDictionary m_categories; // 分类字典（分类列按ID直接取名称）
+    QHash<int, QString> m_snippets; // 搜索摘要（任务ID->带高亮标记的片段）
+    QList<RowDisplay> m_rowDisplay; // 每行的显示文本缓存
+    // 尚未逾期的未完成任务，按(截止时间毫秒, 任务ID)有序，首元素即定时器的下一个触发点
+    std::map<std::pair<qint64, int>, Task> m_pendingDeadlines;
+    qint64 m_armedDeadline = -1;    // 定时器当前等待的截止时间
+    QTimer *m_overdueTimer;         // 下一个截止时间到达时触发的单次定时器
     // 列名映射
     QStringList m_columnNames = {"标题", "描述", "截止时间", "优先级", "分类", "完成状态"};
 };
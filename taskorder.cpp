@@ -0,0 +1,75 @@
+#include "taskorder.h"
+
+TaskOrder::TaskOrder(Key key, Qt::SortOrder order, const CategoryDictionary &categories)
+    : m_key(key)
+    , m_order(order)
+    , m_categories(categories)
+{
+}
+
+TaskOrder::Key TaskOrder::key() const
+{
+    return m_key;
+}
+
+Qt::SortOrder TaskOrder::order() const
+{
+    return m_order;
+}
+
+bool TaskOrder::isDescending() const
+{
+    return m_order == Qt::DescendingOrder;
+}
+
+bool TaskOrder::isDefault() const
+{
+    return m_key == ByDeadline && m_order == Qt::AscendingOrder;
+}
+
+bool TaskOrder::lessThan(const Task &a, const Task &b) const
+{
+    return isDescending() ? ascendingLess(b, a) : ascendingLess(a, b);
+}
+
+qint64 TaskOrder::groupKey(const Task &task) const
+{
+    switch (m_key) {
+    case ByPriority:
+        return task.priority;
+    case ByCategory:
+        return categoryGroupKey(task.categoryId);
+    case ByCompleted:
+        return task.isCompleted ? 1 : 0;
+    default:
+        return 0;
+    }
+}
+
+qint64 TaskOrder::categoryGroupKey(int categoryId) const
+{
+    // 名称序号相同（如都不在字典中）时再按分类ID区分，保证每个分类自成一组
+    return (qint64(m_categories.rank(categoryId)) << 32) | quint32(categoryId);
+}
+
+bool TaskOrder::ascendingLess(const Task &a, const Task &b) const
+{
+    if (m_key == ByTitle) {
+        if (a.title != b.title) {
+            return a.title < b.title;
+        }
+    } else if (m_key != ByDeadline) {
+        qint64 groupA = groupKey(a);
+        qint64 groupB = groupKey(b);
+        if (groupA != groupB) {
+            return groupA < groupB;
+        }
+    }
+    // 与内存任务库的索引一致，截止时间按秒比较
+    qint64 deadlineA = a.deadline.toSecsSinceEpoch();
+    qint64 deadlineB = b.deadline.toSecsSinceEpoch();
+    if (deadlineA != deadlineB) {
+        return deadlineA < deadlineB;
+    }
+    return a.taskId < b.taskId;
+}
@@ -0,0 +1,46 @@
+#ifndef TASKORDER_H
+#define TASKORDER_H
+
+#include <Qt>
+#include "sqlrepository.h"
+#include "categorydictionary.h"
+
+// 任务列表的排序方式：按某一列排序，该列相同时按(截止时间, 任务ID)，构成全序，可用作分页游标的比较规则
+// 降序为整个全序的逆序；默认（截止时间升序）与SQL的ORDER BY deadline, task_id一致
+class TaskOrder
+{
+public:
+    enum Key {
+        ByDeadline,  // 截止时间
+        ByTitle,     // 标题（按UTF-16码元，与内存任务库的标题索引一致；标题排序不经过SQL，与SQLite的BINARY规则即UTF-8字节序
+                     // 在代理对与U+E000–U+FFFF之间先后相反）
+        ByPriority,  // 优先级
+        ByCategory,  // 分类名称（按本地化规则）
+        ByCompleted  // 完成状态（未完成在前）
+    };
+
+    TaskOrder() = default;
+    TaskOrder(Key key, Qt::SortOrder order, const CategoryDictionary &categories = CategoryDictionary());
+
+    Key key() const;
+    Qt::SortOrder order() const;
+    bool isDescending() const;
+    bool isDefault() const; // 截止时间升序
+
+    // a是否排在b之前
+    bool lessThan(const Task &a, const Task &b) const;
+    bool operator()(const Task &a, const Task &b) const { return lessThan(a, b); }
+
+    // 优先级、分类、完成状态排序的分组键：分组键升序排列的各组内再按(截止时间, 任务ID)升序
+    qint64 groupKey(const Task &task) const;
+    qint64 categoryGroupKey(int categoryId) const;
+
+private:
+    bool ascendingLess(const Task &a, const Task &b) const;
+
+    Key m_key = ByDeadline;
+    Qt::SortOrder m_order = Qt::AscendingOrder;
+    CategoryDictionary m_categories; // 按分类排序时提供名称顺序
+};
+
+#endif // TASKORDER_H
@@ -0,0 +1,261 @@
+#include "tasksnapshot.h"
+#include "logging.h"
+#include <QDateTime>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace {
+
+const char kSnapshotMagic[8] = {'T', 'M', 'S', 'N', 'A', 'P', '\0', '\1'};
+const quint32 kSnapshotFormatVersion = 3; // 2：写入时间改为单调递增的写入序号；3：增加数据库标识
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32 formatVersion;
+    quint32 recordCount;
+    qint64 databaseId;   // 数据库标识
+    qint64 generation;   // 数据库任务数据版本号
+    quint64 sequence;    // 写入序号（每次写入递增），用于在两个槽位中选择较新的文件，不受系统时钟调整影响
+    quint64 heapOffset;  // 字符串区起始位置（字节）
+    quint64 heapSize;    // 字符串区长度（字节）
+};
+
+struct SnapshotRecord {
+    qint64 deadline;     // UTC秒级时间戳
+    qint32 taskId;
+    qint32 priority;
+    qint32 categoryId;
+    qint32 isCompleted;
+    quint32 titleOffset; // 字符串区内的偏移（UTF-16字符数）
+    quint32 titleLength;
+    quint32 descriptionOffset;
+    quint32 descriptionLength;
+};
+
+static_assert(sizeof(SnapshotHeader) == 56, "快照头部必须是定长布局");
+static_assert(sizeof(SnapshotRecord) == 40, "快照记录必须是定长布局");
+
+// 读取文件头并做基本校验（不检查记录内容）
+bool readHeader(const uchar *data, qint64 size, SnapshotHeader *header)
+{
+    if (size < qint64(sizeof(SnapshotHeader))) {
+        return false;
+    }
+    std::memcpy(header, data, sizeof(SnapshotHeader));
+    if (std::memcmp(header->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0
+        || header->formatVersion != kSnapshotFormatVersion) {
+        return false;
+    }
+    quint64 recordsEnd = sizeof(SnapshotHeader) + quint64(header->recordCount) * sizeof(SnapshotRecord);
+    return header->heapOffset >= recordsEnd
+        && header->heapSize % sizeof(QChar) == 0
+        && header->heapOffset + header->heapSize == quint64(size);
+}
+
+} // namespace
+
+TaskSnapshot::~TaskSnapshot()
+{
+    close();
+}
+
+bool TaskSnapshot::openLatest(const QString &basePath)
+{
+    close();
+    m_slot = -1;
+    m_version = DataVersion();
+    m_recordCount = 0;
+
+    // 只读取两个槽位的头部比较写入序号，按从新到旧的顺序映射，较新的文件校验失败时使用另一个
+    QList<std::pair<quint64, int>> candidates;
+    for (int slot = 0; slot < 2; ++slot) {
+        QFile file(slotPath(basePath, slot));
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QByteArray headerBytes = file.read(sizeof(SnapshotHeader));
+        SnapshotHeader header;
+        if (headerBytes.size() == int(sizeof(SnapshotHeader))
+            && std::memcmp(headerBytes.constData(), kSnapshotMagic, sizeof(kSnapshotMagic)) == 0) {
+            std::memcpy(&header, headerBytes.constData(), sizeof(SnapshotHeader));
+            if (header.formatVersion == kSnapshotFormatVersion) {
+                candidates.append({header.sequence, slot});
+                // 之后的写入序号必须大于已有的任何文件（包括校验失败的文件）
+                m_lastSequence = qMax(m_lastSequence, header.sequence);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<>());
+    for (const auto &candidate : std::as_const(candidates)) {
+        if (openFile(slotPath(basePath, candidate.second))) {
+            m_slot = candidate.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskSnapshot::openFile(const QString &filePath)
+{
+    m_file = std::make_unique<QFile>(filePath);
+    if (!m_file->open(QIODevice::ReadOnly)) {
+        m_file.reset();
+        return false;
+    }
+    m_size = m_file->size();
+    m_data = m_size > 0 ? m_file->map(0, m_size) : nullptr;
+    SnapshotHeader header;
+    if (!m_data || !readHeader(m_data, m_size, &header)) {
+        qCWarning(lcSql) << "任务快照文件无效，忽略：" << filePath;
+        close();
+        return false;
+    }
+    m_version.databaseId = header.databaseId;
+    m_version.generation = header.generation;
+    m_recordCount = int(header.recordCount);
+    return true;
+}
+
+void TaskSnapshot::close()
+{
+    if (m_data) {
+        m_file->unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    m_file.reset();
+    m_size = 0;
+}
+
+bool TaskSnapshot::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+DataVersion TaskSnapshot::version() const
+{
+    return m_version;
+}
+
+int TaskSnapshot::size() const
+{
+    return m_recordCount;
+}
+
+bool TaskSnapshot::readTasks(QList<Task> *tasks) const
+{
+    SnapshotHeader header;
+    if (!m_data || !readHeader(m_data, m_size, &header)) {
+        return false;
+    }
+
+    const uchar *records = m_data + sizeof(SnapshotHeader);
+    const QChar *heap = reinterpret_cast<const QChar *>(m_data + header.heapOffset);
+    const quint64 heapChars = header.heapSize / sizeof(QChar);
+
+    QList<Task> result;
+    result.reserve(header.recordCount);
+    for (quint32 i = 0; i < header.recordCount; ++i) {
+        SnapshotRecord record;
+        std::memcpy(&record, records + quint64(i) * sizeof(SnapshotRecord), sizeof(SnapshotRecord));
+        if (quint64(record.titleOffset) + record.titleLength > heapChars
+            || quint64(record.descriptionOffset) + record.descriptionLength > heapChars) {
+            qCWarning(lcSql) << "任务快照记录越界，快照文件已损坏：" << m_file->fileName();
+            return false;
+        }
+
+        Task task;
+        task.taskId = record.taskId;
+        // 复制文本：任务会流向模型缓存、搜索结果和其他线程，不能引用关闭后即失效的映射内存
+        task.title = QString(heap + record.titleOffset, record.titleLength);
+        task.description = QString(heap + record.descriptionOffset, record.descriptionLength);
+        task.deadline = QDateTime::fromSecsSinceEpoch(record.deadline);
+        task.priority = record.priority;
+        task.isCompleted = record.isCompleted != 0;
+        task.categoryId = record.categoryId;
+        result.append(task);
+    }
+    *tasks = result;
+    return true;
+}
+
+QString TaskSnapshot::nextWritePath(const QString &basePath) const
+{
+    return slotPath(basePath, m_slot == 0 ? 1 : 0);
+}
+
+quint64 TaskSnapshot::takeNextSequence()
+{
+    return ++m_lastSequence;
+}
+
+QString TaskSnapshot::slotPath(const QString &basePath, int slot)
+{
+    return basePath + "." + QString::number(slot);
+}
+
+bool TaskSnapshot::write(const QString &filePath, const QHash<int, Task> &tasks, const DataVersion &version, quint64 sequence)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcSql) << "写入任务快照失败：" << filePath << file.errorString();
+        return false;
+    }
+
+    // 先写占位头部，记录和字符串区写完后再回填
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // 定长记录：文本位置按字符串区中的累计偏移计算
+    quint64 heapChars = 0;
+    for (const Task &task : tasks) {
+        SnapshotRecord record;
+        record.deadline = task.deadline.toSecsSinceEpoch();
+        record.taskId = task.taskId;
+        record.priority = task.priority;
+        record.categoryId = task.categoryId;
+        record.isCompleted = task.isCompleted ? 1 : 0;
+        record.titleOffset = quint32(heapChars);
+        record.titleLength = quint32(task.title.size());
+        heapChars += task.title.size();
+        record.descriptionOffset = quint32(heapChars);
+        record.descriptionLength = quint32(task.description.size());
+        heapChars += task.description.size();
+        if (heapChars > std::numeric_limits<quint32>::max()) {
+            qCWarning(lcSql) << "任务文本总量超出快照格式上限，不写入快照";
+            file.cancelWriting();
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    }
+
+    // 字符串区：与上面记录的遍历顺序相同（tasks不变时QHash的遍历顺序固定），偏移才能对应
+    for (const Task &task : tasks) {
+        file.write(reinterpret_cast<const char *>(task.title.constData()), task.title.size() * qint64(sizeof(QChar)));
+        file.write(reinterpret_cast<const char *>(task.description.constData()), task.description.size() * qint64(sizeof(QChar)));
+    }
+
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.formatVersion = kSnapshotFormatVersion;
+    header.recordCount = quint32(tasks.size());
+    header.databaseId = version.databaseId;
+    header.generation = version.generation;
+    header.sequence = sequence;
+    header.heapOffset = sizeof(SnapshotHeader) + quint64(tasks.size()) * sizeof(SnapshotRecord);
+    header.heapSize = heapChars * sizeof(QChar);
+    if (!file.seek(0) || file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header))) {
+        file.cancelWriting();
+        return false;
+    }
+
+    // commit()在全部写入成功时才替换目标文件，写入中途的任何错误都会使其返回false
+    if (!file.commit()) {
+        qCWarning(lcSql) << "写入任务快照失败：" << filePath << file.errorString();
+        return false;
+    }
+    qCDebug(lcSql) << "任务快照已写入：" << filePath << "，任务数：" << tasks.size() << "，数据版本号：" << version.generation;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef TASKSNAPSHOT_H
+#define TASKSNAPSHOT_H
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <memory>
+#include "sqlrepository.h"
+
+// 任务快照文件：程序退出前或任务变化后在后台写入，下次启动时以只读方式内存映射，
+// 按定长记录直接构造任务（不经过SQL解析），读取完即可关闭；
+// 快照记录的数据版本（数据库标识和数据版本号）与数据库一致时无需再从SQLite加载全部任务
+//
+// 文件布局（本机字节序）：
+//   Header     定长头部：魔数、格式版本、记录数、数据库标识与数据版本号、写入序号、字符串区位置
+//   Record[N]  定长记录（顺序不限，读取后由TaskStore建立索引），文本以(偏移, 长度)引用字符串区
+//   Heap       字符串区：各任务的标题和描述（UTF-16）依次存放
+//
+// 快照写入启动时所读槽位之外的另一个槽位文件（basePath.0 / basePath.1），启动时读到的文件保留为后备：
+// 启动时选择写入序号较大的有效文件，它损坏时退回另一个
+class TaskSnapshot
+{
+public:
+    TaskSnapshot() = default;
+    ~TaskSnapshot();
+    TaskSnapshot(const TaskSnapshot &) = delete;
+    TaskSnapshot &operator=(const TaskSnapshot &) = delete;
+
+    // 打开两个槽位中较新的有效快照并映射；较新的文件无效时打开另一个
+    bool openLatest(const QString &basePath);
+    void close(); // 解除映射（保留槽位和序号，nextWritePath()仍避开读到的文件）
+
+    bool isOpen() const;
+
+    // 最近一次openLatest()打开的快照的头部信息（close()后仍可读取，没有有效快照时版本无效、任务数为0）
+    DataVersion version() const; // 写入快照时数据库的任务数据版本
+    int size() const;            // 任务数
+
+    // 读取全部任务：标题和描述复制到各自的QString，返回后即可close()；记录越界（文件损坏）时返回false
+    bool readTasks(QList<Task> *tasks) const;
+
+    // 下一次写入应使用的文件（启动时所读槽位之外的另一个）
+    QString nextWritePath(const QString &basePath) const;
+
+    // 下一次写入使用的序号（大于openLatest()见过的所有文件及本次运行已分配的序号），在主线程调用
+    quint64 takeNextSequence();
+
+    // 写入快照（先写临时文件，完成后再替换），不访问成员，可在任意线程调用
+    static bool write(const QString &filePath, const QHash<int, Task> &tasks, const DataVersion &version, quint64 sequence);
+
+private:
+    static QString slotPath(const QString &basePath, int slot);
+    bool openFile(const QString &filePath);
+
+    std::unique_ptr<QFile> m_file;
+    const uchar *m_data = nullptr; // 映射内存起始地址
+    qint64 m_size = 0;             // 映射长度
+    int m_slot = -1;               // 启动时读到的槽位（-1表示没有有效快照）
+    DataVersion m_version;         // 该快照的数据版本
+    int m_recordCount = 0;         // 该快照的任务数
+    quint64 m_lastSequence = 0;    // 已见过或已分配的最大写入序号（close()后保留）
+};
+
+#endif // TASKSNAPSHOT_H
@@ -0,0 +1,368 @@
+#include "taskstore.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// 从游标之后（升序）或之前（降序）开始按序访问有序集合，from为nullptr时从头开始；
+// visit返回false时停止，函数返回false表示已停止、不需要再访问后续集合
+template <typename Set, typename Visit>
+bool scanOrdered(const Set &set, const typename Set::key_type *from, bool descending, Visit visit)
+{
+    if (!descending) {
+        for (auto it = from ? set.upper_bound(*from) : set.begin(); it != set.end(); ++it) {
+            if (!visit(*it)) {
+                return false;
+            }
+        }
+    } else {
+        for (auto it = std::make_reverse_iterator(from ? set.lower_bound(*from) : set.end()); it != set.rend(); ++it) {
+            if (!visit(*it)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void TaskStore::load(const QList<Task> &tasks)
+{
+    clear();
+    m_tasks.reserve(tasks.size());
+    for (const Task &task : tasks) {
+        m_tasks.insert(task.taskId, task);
+        addToIndexes(task);
+    }
+}
+
+void TaskStore::clear()
+{
+    m_tasks.clear();
+    m_byDeadline.clear();
+    m_byCategory.clear();
+    m_byPriority.clear();
+    m_byCompleted[0].clear();
+    m_byCompleted[1].clear();
+    m_byCategoryCompleted.clear();
+    m_byPriorityCompleted.clear();
+    m_comboCounts.clear();
+    m_byTitle.clear();
+}
+
+int TaskStore::size() const
+{
+    return m_tasks.size();
+}
+
+bool TaskStore::contains(int taskId) const
+{
+    return m_tasks.contains(taskId);
+}
+
+Task TaskStore::task(int taskId) const
+{
+    auto it = m_tasks.constFind(taskId);
+    if (it != m_tasks.constEnd()) {
+        return it.value();
+    }
+    Task emptyTask;
+    emptyTask.taskId = -1;
+    return emptyTask;
+}
+
+void TaskStore::insert(const Task &task)
+{
+    // 数据库只保存到秒，内存中同样截断，保证与重新加载后的结果一致
+    Task stored = task;
+    stored.deadline = QDateTime::fromSecsSinceEpoch(task.deadline.toSecsSinceEpoch());
+
+    auto it = m_tasks.find(stored.taskId);
+    if (it != m_tasks.end()) {
+        removeFromIndexes(it.value());
+        it.value() = stored;
+    } else {
+        m_tasks.insert(stored.taskId, stored);
+    }
+    addToIndexes(stored);
+}
+
+void TaskStore::remove(int taskId)
+{
+    auto it = m_tasks.find(taskId);
+    if (it == m_tasks.end()) {
+        return;
+    }
+    removeFromIndexes(it.value());
+    m_tasks.erase(it);
+}
+
+void TaskStore::setCompleted(int taskId, bool isCompleted)
+{
+    auto it = m_tasks.find(taskId);
+    if (it == m_tasks.end() || it->isCompleted == isCompleted) {
+        return;
+    }
+    // 与完成状态有关的索引和计数器整体移除后重新加入
+    removeFromIndexes(it.value());
+    it->isCompleted = isCompleted;
+    addToIndexes(it.value());
+}
+
+QHash<int, Task> TaskStore::tasks() const
+{
+    return m_tasks;
+}
+
+QList<Task> TaskStore::filter(int priority, int categoryId, int completedFilter) const
+{
+    return filterPage(priority, categoryId, completedFilter, TaskCursor(), -1);
+}
+
+QList<Task> TaskStore::filterPage(int priority, int categoryId, int completedFilter,
+                                  const TaskCursor &after, int limit) const
+{
+    QList<Task> tasks;
+    const OrderedIds &ids = candidates(priority, categoryId, completedFilter);
+
+    // 从游标之后开始按序扫描，limit<0表示不限条数
+    auto it = ids.begin();
+    if (!after.isStart()) {
+        it = ids.upper_bound(OrderKey(after.deadline.toSecsSinceEpoch(), after.taskId));
+    }
+    if (limit > 0) {
+        tasks.reserve(limit);
+    }
+    for (; it != ids.end() && (limit < 0 || tasks.size() < limit); ++it) {
+        const Task &task = m_tasks.value(it->second);
+        if (matches(task, priority, categoryId, completedFilter)) {
+            tasks.append(task);
+        }
+    }
+    return tasks;
+}
+
+QList<Task> TaskStore::filterPage(int priority, int categoryId, int completedFilter, const TaskOrder &order,
+                                  const Task *after, int limit) const
+{
+    if (order.isDefault()) {
+        TaskCursor cursor;
+        if (after) {
+            cursor.deadline = after->deadline;
+            cursor.taskId = after->taskId;
+        }
+        return filterPage(priority, categoryId, completedFilter, cursor, limit);
+    }
+
+    QList<Task> tasks;
+    if (limit > 0) {
+        tasks.reserve(limit);
+    }
+    auto accept = [&](int taskId) {
+        const Task &task = m_tasks.value(taskId);
+        if (matches(task, priority, categoryId, completedFilter)) {
+            tasks.append(task);
+        }
+        return limit < 0 || tasks.size() < limit;
+    };
+    auto acceptKey = [&](const OrderKey &key) {
+        return accept(key.second);
+    };
+    const bool descending = order.isDescending();
+
+    switch (order.key()) {
+    case TaskOrder::ByDeadline: {
+        OrderKey from = after ? orderKey(*after) : OrderKey();
+        scanOrdered(candidates(priority, categoryId, completedFilter), after ? &from : nullptr, descending, acceptKey);
+        break;
+    }
+    case TaskOrder::ByTitle: {
+        TitleKey from = after ? titleKey(*after) : TitleKey();
+        scanOrdered(m_byTitle, after ? &from : nullptr, descending, [&](const TitleKey &key) {
+            return accept(std::get<2>(key));
+        });
+        break;
+    }
+    default: {
+        // 分组排序：按分组键顺序依次访问各组的(截止时间, 任务ID)索引；筛选条件与排序列相同时只访问对应的组
+        QList<std::pair<qint64, const OrderedIds *>> groups;
+        if (order.key() == TaskOrder::ByPriority) {
+            for (auto it = m_byPriority.cbegin(); it != m_byPriority.cend(); ++it) {
+                if (priority == -1 || it.key() == priority) {
+                    groups.append({it.key(), &it.value()});
+                }
+            }
+        } else if (order.key() == TaskOrder::ByCategory) {
+            for (auto it = m_byCategory.cbegin(); it != m_byCategory.cend(); ++it) {
+                if (categoryId == -1 || it.key() == categoryId) {
+                    groups.append({order.categoryGroupKey(it.key()), &it.value()});
+                }
+            }
+        } else {
+            for (int completed = 0; completed < 2; ++completed) {
+                if (completedFilter == -1 || (completedFilter == 2) == (completed == 1)) {
+                    groups.append({completed, &m_byCompleted[completed]});
+                }
+            }
+        }
+        std::sort(groups.begin(), groups.end());
+        if (descending) {
+            std::reverse(groups.begin(), groups.end());
+        }
+
+        qint64 afterGroup = after ? order.groupKey(*after) : 0;
+        OrderKey afterKey = after ? orderKey(*after) : OrderKey();
+        for (const auto &group : std::as_const(groups)) {
+            const OrderKey *from = nullptr;
+            if (after) {
+                // 跳过排在游标所在组之前的组，游标所在组从游标之后开始
+                if (descending ? group.first > afterGroup : group.first < afterGroup) {
+                    continue;
+                }
+                if (group.first == afterGroup) {
+                    from = &afterKey;
+                }
+            }
+            if (!scanOrdered(*group.second, from, descending, acceptKey)) {
+                break;
+            }
+        }
+        break;
+    }
+    }
+    return tasks;
+}
+
+int TaskStore::count(int priority, int categoryId, int completedFilter) const
+{
+    // 只有一个筛选条件（或没有）时候选索引即为结果
+    int filterCount = (priority != -1) + (categoryId != -1) + (completedFilter != -1);
+    if (filterCount <= 1) {
+        return int(candidates(priority, categoryId, completedFilter).size());
+    }
+
+    // 多个条件：汇总匹配的组合计数器，耗时与组合数（分类数×优先级数×2）相关而与任务数无关
+    int result = 0;
+    for (const auto &[combo, comboCount] : m_comboCounts) {
+        const auto &[comboCategory, comboPriority, comboCompleted] = combo;
+        if ((categoryId == -1 || comboCategory == categoryId) && (priority == -1 || comboPriority == priority)
+            && (completedFilter == -1 || comboCompleted == (completedFilter == 2))) {
+            result += comboCount;
+        }
+    }
+    return result;
+}
+
+TaskStore::OrderKey TaskStore::orderKey(const Task &task)
+{
+    return OrderKey(task.deadline.toSecsSinceEpoch(), task.taskId);
+}
+
+TaskStore::TitleKey TaskStore::titleKey(const Task &task)
+{
+    return TitleKey(task.title, task.deadline.toSecsSinceEpoch(), task.taskId);
+}
+
+quint64 TaskStore::completedKey(int value, bool isCompleted)
+{
+    return (quint64(quint32(value)) << 1) | quint64(isCompleted);
+}
+
+TaskStore::ComboKey TaskStore::comboKey(const Task &task)
+{
+    return ComboKey(task.categoryId, task.priority, task.isCompleted);
+}
+
+void TaskStore::addToIndexes(const Task &task)
+{
+    OrderKey key = orderKey(task);
+    m_byDeadline.insert(key);
+    m_byCategory[task.categoryId].insert(key);
+    m_byPriority[task.priority].insert(key);
+    m_byCompleted[task.isCompleted ? 1 : 0].insert(key);
+    m_byCategoryCompleted[completedKey(task.categoryId, task.isCompleted)].insert(key);
+    m_byPriorityCompleted[completedKey(task.priority, task.isCompleted)].insert(key);
+    ++m_comboCounts[comboKey(task)];
+    m_byTitle.insert(titleKey(task));
+}
+
+void TaskStore::removeFromIndexes(const Task &task)
+{
+    OrderKey key = orderKey(task);
+    m_byDeadline.erase(key);
+    m_byCompleted[task.isCompleted ? 1 : 0].erase(key);
+    m_byTitle.erase(titleKey(task));
+    eraseFromGroup(m_byCategory, task.categoryId, key);
+    eraseFromGroup(m_byPriority, task.priority, key);
+    eraseFromGroup(m_byCategoryCompleted, completedKey(task.categoryId, task.isCompleted), key);
+    eraseFromGroup(m_byPriorityCompleted, completedKey(task.priority, task.isCompleted), key);
+
+    auto countIt = m_comboCounts.find(comboKey(task));
+    if (countIt != m_comboCounts.end() && --countIt->second == 0) {
+        m_comboCounts.erase(countIt);
+    }
+}
+
+template <typename Key>
+void TaskStore::eraseFromGroup(QHash<Key, OrderedIds> &groups, const Key &group, const OrderKey &key)
+{
+    auto it = groups.find(group);
+    if (it != groups.end()) {
+        it->erase(key);
+        if (it->empty()) {
+            groups.erase(it);
+        }
+    }
+}
+
+const TaskStore::OrderedIds &TaskStore::candidates(int priority, int categoryId, int completedFilter) const
+{
+    // 在与筛选条件完全对应或为其超集的索引中取最小者；完成状态与分类/优先级同时筛选时使用组合索引
+    const OrderedIds *best = &m_byDeadline;
+    auto consider = [&](const auto &groups, auto group) {
+        auto it = groups.constFind(group);
+        if (it == groups.constEnd()) {
+            return false;
+        }
+        if (it->size() < best->size()) {
+            best = &it.value();
+        }
+        return true;
+    };
+
+    if (completedFilter != -1) {
+        const bool isCompleted = completedFilter == 2;
+        if (m_byCompleted[isCompleted ? 1 : 0].size() < best->size()) {
+            best = &m_byCompleted[isCompleted ? 1 : 0];
+        }
+        if (priority != -1 && !consider(m_byPriorityCompleted, completedKey(priority, isCompleted))) {
+            return m_empty;
+        }
+        if (categoryId != -1 && !consider(m_byCategoryCompleted, completedKey(categoryId, isCompleted))) {
+            return m_empty;
+        }
+    } else {
+        if (priority != -1 && !consider(m_byPriority, priority)) {
+            return m_empty;
+        }
+        if (categoryId != -1 && !consider(m_byCategory, categoryId)) {
+            return m_empty;
+        }
+    }
+    return *best;
+}
+
+bool TaskStore::matches(const Task &task, int priority, int categoryId, int completedFilter)
+{
+    if (priority != -1 && task.priority != priority) {
+        return false;
+    }
+    if (categoryId != -1 && task.categoryId != categoryId) {
+        return false;
+    }
+    if (completedFilter != -1 && task.isCompleted != (completedFilter == 2)) {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef TASKSTORE_H
+#define TASKSTORE_H
+
+#include <QHash>
+#include <QList>
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+#include "sqlrepository.h"
+#include "taskorder.h"
+
+// 内存任务库：启动时从数据库全量加载，之后由TaskManager在每次写库成功后同步更新（写穿透）
+// 除主索引（任务ID）外，按分类、优先级、完成状态及(分类, 完成状态)、(优先级, 完成状态)组合
+// 各维护一份按(截止时间, 任务ID)排序的二级索引，任意筛选组合都从最小的候选索引按序扫描，
+// 结果顺序与SQL的ORDER BY deadline, task_id一致；计数由按(分类, 优先级, 完成状态)组合维护的计数器汇总
+// 其他排序方式同样由常驻的有序索引给出（写入时O(log n)增量维护），切换排序无需重新排序
+class TaskStore
+{
+public:
+    // 全量加载（替换现有数据）
+    void load(const QList<Task> &tasks);
+    void clear();
+
+    int size() const;
+    bool contains(int taskId) const;
+    Task task(int taskId) const; // 不存在时返回taskId为-1的任务
+    // 全部任务（无序）：返回隐式共享的主存储，不复制任务，可交给其他线程只读遍历；
+    // 之后本库再被修改时才会分离出独立副本
+    QHash<int, Task> tasks() const;
+
+    void insert(const Task &task); // 新增或整体替换同ID任务
+    void remove(int taskId);
+    void setCompleted(int taskId, bool isCompleted);
+
+    // 筛选接口：-1表示不筛选；completedFilter：1=未完成，2=已完成（与SqlRepository一致）
+    QList<Task> filter(int priority, int categoryId, int completedFilter) const;
+    QList<Task> filterPage(int priority, int categoryId, int completedFilter, const TaskCursor &after, int limit) const;
+    // 按指定排序方式分页：返回排在after之后的最多limit条任务，after为nullptr时从第一条开始
+    QList<Task> filterPage(int priority, int categoryId, int completedFilter, const TaskOrder &order,
+                           const Task *after, int limit) const;
+    int count(int priority, int categoryId, int completedFilter) const;
+    // 判断单个任务是否满足筛选条件（参数含义同filter）
+    static bool matches(const Task &task, int priority, int categoryId, int completedFilter);
+
+private:
+    using OrderKey = std::pair<qint64, int>; // (截止时间戳, 任务ID)
+    using OrderedIds = std::set<OrderKey>;
+    using TitleKey = std::tuple<QString, qint64, int>; // (标题, 截止时间戳, 任务ID)
+    using ComboKey = std::tuple<int, int, bool>;        // (分类ID, 优先级, 完成状态)
+
+    static OrderKey orderKey(const Task &task);
+    static TitleKey titleKey(const Task &task);
+    // 组合索引的键：(分类ID或优先级, 完成状态)
+    static quint64 completedKey(int value, bool isCompleted);
+    static ComboKey comboKey(const Task &task);
+
+    void addToIndexes(const Task &task);
+    void removeFromIndexes(const Task &task);
+    // 从按键分组的索引中移除，组为空时删除该组
+    template <typename Key>
+    static void eraseFromGroup(QHash<Key, OrderedIds> &groups, const Key &group, const OrderKey &key);
+    // 选出筛选条件对应的最小候选索引（按截止时间有序）
+    const OrderedIds &candidates(int priority, int categoryId, int completedFilter) const;
+
+    QHash<int, Task> m_tasks;              // 主存储：任务ID -> 任务
+    OrderedIds m_byDeadline;               // 全部任务
+    QHash<int, OrderedIds> m_byCategory;   // 分类ID -> 任务
+    QHash<int, OrderedIds> m_byPriority;   // 优先级 -> 任务
+    OrderedIds m_byCompleted[2];           // [0]=未完成，[1]=已完成
+    QHash<quint64, OrderedIds> m_byCategoryCompleted; // (分类ID, 完成状态) -> 任务
+    QHash<quint64, OrderedIds> m_byPriorityCompleted; // (优先级, 完成状态) -> 任务
+    std::map<ComboKey, int> m_comboCounts; // (分类ID, 优先级, 完成状态) -> 任务数（组合数远小于任务数）
+    std::set<TitleKey> m_byTitle;          // 按标题排序的全部任务
+    OrderedIds m_empty;                    // 无匹配时使用的空索引
+};
+
+#endif // TASKSTORE_H
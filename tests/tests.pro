@@ -0,0 +1,4 @@
+# 测试工程：qmake tests/tests.pro && make && make check
+TEMPLATE = subdirs
+
+SUBDIRS += tst_sqlrepository.pro
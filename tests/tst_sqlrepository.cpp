@@ -0,0 +1,316 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include "sqlrepository.h"
+
+// SqlRepository测试：
+// - 各仓库查询的EXPLAIN QUERY PLAN使用预期的索引（或全文表），且不出现对task表的全表扫描（SCAN task且未使用索引）；
+//   计划由SqlRepository::queryPlansFor()按仓库实际执行的语句和绑定值取得，测试中不重复SQL
+// - 基准测试：预编译语句缓存前后的单次耗时、逐行与批量写入、启动时打开已是最新结构的数据库
+class TestSqlRepository : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void queryPlan_data();
+    void queryPlan();
+
+    void preparedStatement_data();
+    void preparedStatement();
+    void bulkInsert_data();
+    void bulkInsert();
+    void startup();
+
+private:
+    static constexpr int kSeedRows = 20000; // 查询计划用例的数据量（表过小时优化器可能直接扫描）
+    static constexpr int kBulkRows = 100000; // 逐行与批量写入基准的行数
+
+    static QList<Task> makeTasks(int count, int seed);
+    // 调用queryPlan用例对应的仓库接口
+    void runOperation(const QString &operation, int priority, int categoryId, int completedFilter);
+
+    QTemporaryDir m_dir;
+    QString m_databasePath;
+    SqlRepository *m_repo = nullptr;
+    QSqlDatabase m_plainConnection; // 不经过SqlRepository的连接：“无缓存”基准
+};
+
+namespace {
+
+// “无缓存”基准按缓存之前的做法自行prepare的语句
+const QString kTaskColumns = "task_id, title, description, deadline, priority, is_completed, category_id";
+const QString kInsertTaskSql = "INSERT INTO task (title, description, deadline, priority, is_completed, category_id) VALUES (?, ?, ?, ?, ?, ?)";
+
+const QString kSearchKeyword = "任务12"; // 至少3个字符，走全文索引
+
+} // namespace
+
+void TestSqlRepository::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_databasePath = m_dir.filePath("TaskManager.db");
+    m_repo = new SqlRepository(m_databasePath);
+    QVERIFY(m_repo->isConnected());
+    QCOMPARE(m_repo->addTasks(makeTasks(kSeedRows, 1)).size(), kSeedRows);
+
+    m_plainConnection = QSqlDatabase::addDatabase("QSQLITE", "tst_plain");
+    m_plainConnection.setDatabaseName(m_databasePath);
+    QVERIFY(m_plainConnection.open());
+}
+
+void TestSqlRepository::cleanupTestCase()
+{
+    m_plainConnection.close();
+    m_plainConnection = QSqlDatabase();
+    QSqlDatabase::removeDatabase("tst_plain");
+    delete m_repo;
+    m_repo = nullptr;
+}
+
+QList<Task> TestSqlRepository::makeTasks(int count, int seed)
+{
+    QRandomGenerator random(seed);
+    const qint64 base = QDateTime::currentSecsSinceEpoch();
+    QList<Task> tasks;
+    tasks.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Task task;
+        task.taskId = -1;
+        task.title = QString("任务%1").arg(i);
+        task.description = QString("描述%1").arg(i);
+        task.deadline = QDateTime::fromSecsSinceEpoch(base + random.bounded(-30 * 86400, 90 * 86400));
+        task.priority = 1 + random.bounded(3);
+        task.isCompleted = random.bounded(2) == 1;
+        task.categoryId = 1 + random.bounded(4);
+        tasks.append(task);
+    }
+    return tasks;
+}
+
+void TestSqlRepository::runOperation(const QString &operation, int priority, int categoryId, int completedFilter)
+{
+    if (operation == "filter") {
+        m_repo->getTasksByFilter(priority, categoryId, completedFilter);
+    } else if (operation == "page_first") {
+        m_repo->getTasksPage(priority, categoryId, completedFilter, TaskCursor(), 200);
+    } else if (operation == "page_next") {
+        TaskCursor cursor;
+        cursor.deadline = QDateTime::currentDateTime();
+        cursor.taskId = 100;
+        m_repo->getTasksPage(priority, categoryId, completedFilter, cursor, 200);
+    } else if (operation == "count") {
+        m_repo->countTasksByFilter(priority, categoryId, completedFilter);
+    } else if (operation == "reminder") {
+        m_repo->getPendingTasksWithReminder(30);
+    } else if (operation == "statistics") {
+        int totalTasks = 0;
+        int completedTasks = 0;
+        m_repo->getTaskStatistics(totalTasks, completedTasks);
+    } else if (operation == "statistics_breakdown") {
+        m_repo->getTaskStatisticsBreakdown();
+    } else if (operation == "search") {
+        m_repo->searchTasks(kSearchKeyword);
+    } else if (operation == "task_by_id") {
+        m_repo->getTaskById(1);
+    } else if (operation == "category_used") {
+        m_repo->isCategoryUsed(categoryId);
+    } else {
+        QFAIL(qPrintable("未知的查询用例：" + operation));
+    }
+}
+
+void TestSqlRepository::queryPlan_data()
+{
+    QTest::addColumn<QString>("operation");
+    QTest::addColumn<int>("priority");
+    QTest::addColumn<int>("categoryId");
+    QTest::addColumn<int>("completedFilter");
+    QTest::addColumn<QStringList>("expected"); // 计划中须出现其中之一（索引名、全文表名或主键查找）
+
+    const QString priorityIndex = "idx_task_priority_completed_deadline";
+    const QString categoryIndex = "idx_task_category_completed_deadline";
+    const QString completedIndex = "idx_task_completed_deadline";
+
+    // 筛选条件的全部组合（优先级、分类、完成状态各自筛选或不筛选）
+    for (int priority : {-1, 2}) {
+        for (int categoryId : {-1, 3}) {
+            for (int completedFilter : {-1, 1}) {
+                QStringList expected;
+                if (priority != -1 && categoryId != -1) {
+                    expected = QStringList{priorityIndex, categoryIndex}; // 两个索引代价相当，由优化器任选其一
+                } else if (priority != -1) {
+                    expected = QStringList{priorityIndex};
+                } else if (categoryId != -1) {
+                    expected = QStringList{categoryIndex};
+                } else if (completedFilter != -1) {
+                    expected = QStringList{completedIndex};
+                } else {
+                    expected = QStringList{"idx_task_deadline"};
+                }
+
+                const QString name = QString("p%1_c%2_s%3").arg(priority).arg(categoryId).arg(completedFilter);
+                for (const char *operation : {"filter", "page_first", "page_next", "count"}) {
+                    QTest::newRow(qPrintable(QString("%1_%2").arg(operation, name)))
+                        << QString(operation) << priority << categoryId << completedFilter << expected;
+                }
+            }
+        }
+    }
+
+    QTest::newRow("reminder") << "reminder" << -1 << -1 << -1 << QStringList{completedIndex};
+    QTest::newRow("statistics") << "statistics" << -1 << -1 << -1 << QStringList{"task_stats"};
+    // 汇总表之外的逾期数查询
+    QTest::newRow("statistics_breakdown") << "statistics_breakdown" << -1 << -1 << -1 << QStringList{completedIndex};
+    QTest::newRow("search") << "search" << -1 << -1 << -1 << QStringList{"task_fts"};
+    QTest::newRow("task_by_id") << "task_by_id" << -1 << -1 << -1 << QStringList{"INTEGER PRIMARY KEY"};
+    QTest::newRow("category_used") << "category_used" << -1 << 3 << -1 << QStringList{categoryIndex};
+}
+
+void TestSqlRepository::queryPlan()
+{
+    QFETCH(QString, operation);
+    QFETCH(int, priority);
+    QFETCH(int, categoryId);
+    QFETCH(int, completedFilter);
+    QFETCH(QStringList, expected);
+
+    if (operation == "search" && !m_repo->usesFullTextIndex(kSearchKeyword)) {
+        QSKIP("当前SQLite不支持FTS5 trigram分词，搜索使用LIKE扫描");
+    }
+
+    const QMap<QString, QStringList> plans = m_repo->queryPlansFor([&]() {
+        runOperation(operation, priority, categoryId, completedFilter);
+    });
+    QVERIFY2(!plans.isEmpty(), qPrintable("未执行任何预编译语句：" + operation));
+
+    // SQLite 3.36起为“SCAN task”，更早的版本为“SCAN TABLE task”；t为搜索语句中task的别名；
+    // 按索引顺序扫描（USING INDEX）不算全表扫描
+    static const QRegularExpression fullScan("^SCAN (TABLE )?(task|t)( |$)");
+    QStringList planText;
+    bool usesExpected = false;
+    for (auto it = plans.cbegin(); it != plans.cend(); ++it) {
+        QVERIFY2(!it.value().isEmpty(), qPrintable("无法获取查询计划：" + it.key()));
+        planText.append(it.key());
+        for (const QString &detail : it.value()) {
+            planText.append("  " + detail);
+            QVERIFY2(!fullScan.match(detail).hasMatch() || detail.contains("USING"),
+                     qPrintable(QString("全表扫描：%1\nSQL：%2").arg(detail, it.key())));
+            for (const QString &name : expected) {
+                usesExpected = usesExpected || detail.contains(name);
+            }
+        }
+    }
+    QVERIFY2(usesExpected, qPrintable(QString("查询计划未使用%1：\n%2").arg(expected.join("或"), planText.join("\n"))));
+}
+
+void TestSqlRepository::preparedStatement_data()
+{
+    QTest::addColumn<QString>("operation");
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("insert_uncached") << "insert" << false;
+    QTest::newRow("insert_cached") << "insert" << true;
+    QTest::newRow("filter_uncached") << "filter" << false;
+    QTest::newRow("filter_cached") << "filter" << true;
+}
+
+void TestSqlRepository::preparedStatement()
+{
+    QFETCH(QString, operation);
+    QFETCH(bool, cached);
+
+    // 单行写入与筛选查询的单次耗时：uncached每次新建QSqlQuery并重新prepare（缓存之前的做法），
+    // cached走SqlRepository的预编译语句缓存
+    // 参考结果（PySide6 QtSql按同样步骤实测，SQLite 3.53，ext4，单核Xeon）：单行写入约240→170µs/次；
+    // 筛选查询约6~9ms/次，两者差异在波动范围内（prepare约25~30µs，耗时主要在读取约3300行结果）
+    const Task task = makeTasks(1, 2).first();
+    const QString filterSql = "SELECT " + kTaskColumns
+        + " FROM task WHERE 1=1 AND priority = ? AND is_completed = ? ORDER BY deadline ASC";
+
+    if (operation == "insert") {
+        if (cached) {
+            QBENCHMARK {
+                QVERIFY(m_repo->addTask(task));
+            }
+        } else {
+            QBENCHMARK {
+                QSqlQuery query(m_plainConnection);
+                QVERIFY(query.prepare(kInsertTaskSql));
+                query.bindValue(0, task.title);
+                query.bindValue(1, task.description);
+                query.bindValue(2, task.deadline.toSecsSinceEpoch());
+                query.bindValue(3, task.priority);
+                query.bindValue(4, task.isCompleted ? 1 : 0);
+                query.bindValue(5, task.categoryId);
+                QVERIFY(query.exec());
+            }
+        }
+    } else {
+        if (cached) {
+            QBENCHMARK {
+                QVERIFY(!m_repo->getTasksByFilter(3, -1, 1).isEmpty());
+            }
+        } else {
+            QBENCHMARK {
+                QSqlQuery query(m_plainConnection);
+                QVERIFY(query.prepare(filterSql));
+                query.bindValue(0, 3);
+                query.bindValue(1, 0);
+                QVERIFY(query.exec());
+                int rows = 0;
+                while (query.next()) {
+                    ++rows;
+                }
+                QVERIFY(rows > 0);
+            }
+        }
+    }
+}
+
+void TestSqlRepository::bulkInsert_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("row_by_row") << false;
+    QTest::newRow("batched") << true;
+}
+
+void TestSqlRepository::bulkInsert()
+{
+    QFETCH(bool, batched);
+
+    // 逐行写入每行一个自动提交事务；批量接口整批一个事务并复用同一条预编译语句
+    // 参考结果（同上环境，含全文索引和统计触发器）：10万行逐行约25s，批量约11s
+    const QList<Task> tasks = makeTasks(kBulkRows, 3);
+    QBENCHMARK_ONCE {
+        if (batched) {
+            QCOMPARE(m_repo->addTasks(tasks).size(), kBulkRows);
+        } else {
+            for (const Task &task : tasks) {
+                QVERIFY(m_repo->addTask(task));
+            }
+        }
+    }
+}
+
+void TestSqlRepository::startup()
+{
+    // 打开已是最新结构的数据库：只读取一次user_version，不执行迁移、默认分类写入和诊断查询
+    // （从进程启动到表格首次绘制的完整耗时由程序的taskmanager.startup日志输出）
+    const int latestVersion = m_repo->schemaVersion();
+    QVERIFY(latestVersion > 0);
+    QBENCHMARK {
+        SqlRepository repo(m_databasePath);
+        QVERIFY(repo.isConnected());
+        QCOMPARE(repo.schemaVersion(), latestVersion);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSqlRepository)
+#include "tst_sqlrepository.moc"
@@ -0,0 +1,20 @@
+# SqlRepository测试（查询计划检查与基准测试），被测源文件直接从上级目录编译
+QT += core sql testlib
+QT -= gui
+LIBS += -lsqlite3  # 同TaskManager.pro：SqlRepository直接调用SQLite C API
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+DEFINES += QT_DEPRECATED_WARNINGS
+
+TARGET = tst_sqlrepository
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += tst_sqlrepository.cpp \
+           ../sqlrepository.cpp \
+           ../logging.cpp
+
+HEADERS += ../sqlrepository.h \
+           ../logging.h